@@ -0,0 +1,197 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "board_batch.hpp"
+#include "engine.hpp"
+#include "grid.hpp"
+
+namespace {
+
+using tictactoe::Engine;
+using tictactoe::GameRules;
+
+std::vector<int> shuffled_cells(const GameRules& rules, std::uint32_t seed) {
+  std::vector<int> cells(static_cast<std::size_t>(rules.num_cells()));
+  std::iota(cells.begin(), cells.end(), 0);
+  std::mt19937 rng{seed};
+  std::shuffle(cells.begin(), cells.end(), rng);
+  return cells;
+}
+
+void BoardSizes(benchmark::internal::Benchmark* b) {
+  for (const int n : {3, 4, 8, 16, 32, 64, 128, 256}) {
+    b->Arg(n);
+  }
+}
+
+// Cost of a single move: plays random games and reports moves per second.
+// The engine is created once and each game is taken back with the O(1)
+// unmake_move(), so setting up the board does not count as moves.
+void BM_HandleFieldSelected(benchmark::State& state) {
+  const auto rules = GameRules::square(static_cast<int>(state.range(0)));
+  const auto order = shuffled_cells(rules, 42);
+
+  auto engine = Engine::create_engine(rules).value();
+  std::int64_t moves = 0;
+  for (auto _ : state) {
+    for (const int cell : order) {
+      benchmark::DoNotOptimize(
+          engine.handle_field_selected(engine.position_of(cell)));
+      ++moves;
+      if (engine.maybe_winner()) {
+        break;
+      }
+    }
+    while (engine.can_undo()) {
+      engine.unmake_move();
+    }
+  }
+  state.SetItemsProcessed(moves);
+}
+BENCHMARK(BM_HandleFieldSelected)->Apply(BoardSizes);
+
+// Reference full-board scan on a half filled board.
+void BM_MaybeGetWinner(benchmark::State& state) {
+  const auto rules = GameRules::square(static_cast<int>(state.range(0)));
+  const auto order = shuffled_cells(rules, 7);
+
+  auto engine = Engine::create_engine(rules).value();
+  for (std::size_t i = 0; i < order.size() / 2 and !engine.maybe_winner();
+       ++i) {
+    (void)engine.handle_field_selected(engine.position_of(order[i]));
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(engine.maybe_get_winner());
+  }
+  state.SetItemsProcessed(state.iterations() * rules.num_cells());
+}
+BENCHMARK(BM_MaybeGetWinner)->Apply(BoardSizes);
+
+// Whole random games from the empty board; reports games per second.
+void BM_RandomPlayout(benchmark::State& state, GameRules rules) {
+  std::mt19937 rng{1234};
+  std::vector<int> cells(static_cast<std::size_t>(rules.num_cells()));
+
+  for (auto _ : state) {
+    auto engine = Engine::create_engine(rules).value();
+    std::iota(cells.begin(), cells.end(), 0);
+    std::shuffle(cells.begin(), cells.end(), rng);
+    for (const int cell : cells) {
+      (void)engine.handle_field_selected(engine.position_of(cell));
+      if (engine.maybe_winner()) {
+        break;
+      }
+    }
+    benchmark::DoNotOptimize(engine.maybe_winner());
+  }
+  state.counters["games_per_second"] = benchmark::Counter(
+      static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+BENCHMARK_CAPTURE(BM_RandomPlayout, 3x3, GameRules::square(3));
+BENCHMARK_CAPTURE(BM_RandomPlayout, 4x4, GameRules::square(4));
+BENCHMARK_CAPTURE(BM_RandomPlayout, 8x8, GameRules::square(8));
+BENCHMARK_CAPTURE(BM_RandomPlayout, gomoku, GameRules{15, 15, 5});
+
+void BatchArgs(benchmark::internal::Benchmark* b) {
+  for (const int n : {3, 8, 15}) {
+    for (const auto level :
+         {tictactoe::SimdLevel::Scalar, tictactoe::SimdLevel::Sse2,
+          tictactoe::SimdLevel::Avx2}) {
+      b->Args({n, static_cast<int>(level)});
+    }
+  }
+}
+
+// Batch classification of arbitrary boards; the second argument is the
+// SimdLevel. Items are boards.
+void BM_EvaluateBatch(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const GameRules rules{n, n, std::min(n, 5)};
+  const auto level = static_cast<tictactoe::SimdLevel>(state.range(1));
+  constexpr int kBoards = 4096;
+  // evaluate() would quietly run a lower level under this one's name
+  if (level > tictactoe::best_simd_level()) {
+    state.SkipWithError("SIMD level not supported by this CPU");
+    return;
+  }
+
+  std::mt19937 rng{99};
+  tictactoe::BoardBatch batch{rules, kBoards};
+  for (std::size_t board = 0; board < batch.size(); ++board) {
+    for (int cell = 0; cell < rules.num_cells(); ++cell) {
+      const auto roll = rng() % 3;
+      batch.set(board, cell,
+                roll == 0   ? tictactoe::FieldState::Empty
+                : roll == 1 ? tictactoe::FieldState::Cross
+                            : tictactoe::FieldState::Circle);
+    }
+  }
+
+  std::vector<tictactoe::BoardStatus> statuses(batch.size());
+  for (auto _ : state) {
+    tictactoe::evaluate(batch, statuses, level);
+    benchmark::DoNotOptimize(statuses.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kBoards);
+}
+BENCHMARK(BM_EvaluateBatch)->ArgNames({"side", "simd"})->Apply(BatchArgs);
+
+// The grid benchmarks create SFML textures and therefore need a display
+// (e.g. Xvfb on a headless machine).
+tictactoe::Configuration BenchConfiguration() {
+  tictactoe::Configuration config;
+  config.asset_dir = "assets";
+  return config;
+}
+
+void BM_GridUpdateGrid(benchmark::State& state) {
+  auto engine =
+      Engine::create_engine(static_cast<int>(state.range(0))).value();
+  tictactoe::Grid grid{BenchConfiguration(), engine};
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(grid.update_grid());
+  }
+  state.SetItemsProcessed(state.iterations() * engine.rules().num_cells());
+}
+BENCHMARK(BM_GridUpdateGrid)->Apply(BoardSizes);
+
+// Per-move refresh of a single field.
+void BM_GridUpdateField(benchmark::State& state) {
+  auto engine =
+      Engine::create_engine(static_cast<int>(state.range(0))).value();
+  tictactoe::Grid grid{BenchConfiguration(), engine};
+  const auto pos = engine.position_of(engine.rules().num_cells() - 1);
+
+  for (auto _ : state) {
+    grid.update_field(pos);
+  }
+}
+BENCHMARK(BM_GridUpdateField)->Apply(BoardSizes);
+
+// Click on an occupied field: the cost of locating the clicked field,
+// without the cost of a successful move.
+void BM_GridHandleClick(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  auto engine = Engine::create_engine(n).value();
+  tictactoe::Grid grid{BenchConfiguration(), engine};
+
+  const auto board = grid.get_board_size();
+  const sf::Vector2f last_field{board.x - 2.0f, board.y - 2.0f};
+  (void)grid.handle_click(last_field);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(grid.handle_click(last_field));
+  }
+}
+BENCHMARK(BM_GridHandleClick)->Apply(BoardSizes);
+
+}  // namespace
+
+BENCHMARK_MAIN();
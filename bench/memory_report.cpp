@@ -0,0 +1,40 @@
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "engine.hpp"
+
+// Usage: memory_report [games]
+//
+// Prints the bytes a board and a whole Engine take per board size, with the
+// packed two-bit fields next to the previous layout of one int-sized
+// FieldState per field, and what holding `games` engines at once (e.g. on
+// the game server) adds up to.
+int main(int argc, const char** argv) {
+  const std::vector<std::string> args = {argv, argv + argc};
+  const auto games = args.size() > 1 ? std::stoull(args[1]) : 10'000ULL;
+
+  fmt::print("{:>10} {:>12} {:>12} {:>12} {:>14} {:>14}\n", "board",
+             "int fields", "packed", "engine", "engine w/ int",
+             fmt::format("{} games", games));
+
+  for (const int n : {3, 8, 15, 64, 256, 1024}) {
+    const tictactoe::GameRules rules{n, n, std::min(n, 5)};
+    const auto engine = tictactoe::Engine::create_engine(rules);
+    if (!engine) {
+      fmt::print(stderr, "invalid board size {}\n", n);
+      return EXIT_FAILURE;
+    }
+    const auto m = engine.value().memory_usage();
+    const auto unpacked =
+        m.total_bytes - m.board_bytes + m.unpacked_board_bytes;
+    fmt::print("{:>10} {:>12} {:>12} {:>12} {:>14} {:>11.1f} MB\n",
+               fmt::format("{}x{}", n, n), m.unpacked_board_bytes,
+               m.board_bytes, m.total_bytes, unpacked,
+               static_cast<double>(m.total_bytes * games) / 1e6);
+  }
+  return EXIT_SUCCESS;
+}
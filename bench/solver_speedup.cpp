@@ -0,0 +1,58 @@
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "parallel_solver.hpp"
+
+// Usage: solver_speedup [board_size] [max_threads]
+//
+// Solves the empty board with 1, 2, 4, ... threads up to max_threads and
+// prints the wall time and the speedup relative to the single-threaded run.
+int main(int argc, const char** argv) {
+  const std::vector<std::string> args = {argv, argv + argc};
+  const int board_size = args.size() > 1 ? std::stoi(args[1]) : 4;
+  const unsigned max_threads = std::max(
+      1U, args.size() > 2 ? static_cast<unsigned>(std::stoul(args[2]))
+                          : std::thread::hardware_concurrency());
+
+  auto engine = tictactoe::Engine::create_engine(board_size);
+  if (!engine) {
+    fmt::print(stderr, "invalid board size {}\n", board_size);
+    return EXIT_FAILURE;
+  }
+
+  std::vector<unsigned> thread_counts;
+  for (unsigned t = 1; t < max_threads; t *= 2) {
+    thread_counts.push_back(t);
+  }
+  thread_counts.push_back(max_threads);
+
+  fmt::print("{:>8} {:>8} {:>14} {:>12} {:>8}\n", "threads", "value",
+             "nodes", "time [ms]", "speedup");
+
+  double baseline_ms = 0.0;
+  for (const auto threads : thread_counts) {
+    // fresh solver per run, so no run benefits from an earlier one's table
+    tictactoe::ParallelSolver solver{engine.value().rules(),
+                                     tictactoe::SolverOptions{threads, 2, 24}};
+    const auto result = solver.solve(engine.value());
+    if (!result) {
+      fmt::print(stderr, "solve failed: {}\n", result.error().message());
+      return EXIT_FAILURE;
+    }
+
+    const double ms = static_cast<double>(result.value().elapsed.count()) / 1e3;
+    if (threads == 1) {
+      baseline_ms = ms;
+    }
+    fmt::print("{:>8} {:>8} {:>14} {:>12.1f} {:>8.2f}\n", threads,
+               static_cast<int>(result.value().value), result.value().nodes, ms,
+               baseline_ms / ms);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,283 @@
+#include <fmt/format.h>
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <numeric>
+#include <string>
+#include <system_error>
+#include <variant>
+#include <vector>
+
+#include "camera.hpp"
+#include "configuration.hpp"
+#include "engine.hpp"
+#include "grid.hpp"
+#include "input_script.hpp"
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+// Usage: ui_replay [script | event count] [board size]
+//
+// Replays an input script recorded with the game's --record-input, or that
+// many synthetic events (10000 by default) on a board_size board (15 by
+// default), as fast as possible. Every event goes through the same path as
+// in the game: clicks into Grid::handle_click, resizes into a new viewport,
+// recorded moves, undos and redos into the engine and Grid::update_field,
+// and each is followed by a frame drawn into an off-screen
+// sf::RenderTexture, so no window is opened. In synthetic scripts a
+// finished game is replaced by a new one. Prints the frame times and the
+// allocations per frame for clicks, resizes and moves; SFML still needs an
+// OpenGL context, e.g. from Xvfb on a headless machine.
+//
+// Frame times are CPU times up to the end of display(); the GPU may still
+// be drawing. Allocations are counted through operator new, so allocations
+// made with malloc inside SFML and the driver are not included.
+
+namespace {
+
+std::atomic<std::uint64_t> allocations{0};
+std::atomic<std::uint64_t> allocated_bytes{0};
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Frame {
+  Clock::duration time;
+  std::uint64_t allocations;
+  std::uint64_t bytes;
+};
+
+// Plays a recorded move, undo or redo; fails if the script does not fit the
+// game, e.g. a move onto a taken field.
+outcome::result<void> apply_move(const tictactoe::ScriptedEvent& event,
+                                 tictactoe::Engine& engine,
+                                 tictactoe::Grid& grid) {
+  if (const auto* move = std::get_if<tictactoe::ScriptedMove>(&event)) {
+    const auto pos =
+        OUTCOME_TRYX(tictactoe::Position::create_position_for_engine(
+            move->row, move->col, engine));
+    OUTCOME_TRYV(engine.handle_field_selected(pos));
+    grid.update_field(pos);
+  } else if (std::holds_alternative<tictactoe::ScriptedUndo>(event)) {
+    if (!engine.can_undo()) {
+      return std::errc::operation_not_permitted;
+    }
+    const auto pos = engine.position_of(engine.move_history().back());
+    OUTCOME_TRYV(engine.undo());
+    grid.update_field(pos);
+  } else {
+    OUTCOME_TRYV(engine.redo());
+    grid.update_field(engine.position_of(engine.move_history().back()));
+  }
+  return outcome::success();
+}
+
+void print_summary(const char* kind, std::vector<Frame> frames) {
+  if (frames.empty()) {
+    fmt::print("{:>8} {:>8}\n", kind, 0);
+    return;
+  }
+  std::sort(frames.begin(), frames.end(),
+            [](const Frame& a, const Frame& b) { return a.time < b.time; });
+  const auto micros = [](Clock::duration d) {
+    return std::chrono::duration<double, std::micro>(d).count();
+  };
+  const auto at = [&](double quantile) {
+    const auto index =
+        static_cast<std::size_t>(quantile * static_cast<double>(frames.size()));
+    return micros(frames[std::min(index, frames.size() - 1)].time);
+  };
+  const auto count = static_cast<double>(frames.size());
+  const auto total_time = std::accumulate(
+      frames.begin(), frames.end(), Clock::duration{},
+      [](Clock::duration sum, const Frame& f) { return sum + f.time; });
+  const auto total_allocations = std::accumulate(
+      frames.begin(), frames.end(), std::uint64_t{0},
+      [](std::uint64_t sum, const Frame& f) { return sum + f.allocations; });
+  const auto total_bytes = std::accumulate(
+      frames.begin(), frames.end(), std::uint64_t{0},
+      [](std::uint64_t sum, const Frame& f) { return sum + f.bytes; });
+  const auto most_allocations =
+      std::max_element(frames.begin(), frames.end(),
+                       [](const Frame& a, const Frame& b) {
+                         return a.allocations < b.allocations;
+                       })
+          ->allocations;
+
+  fmt::print(
+      "{:>8} {:>8} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.2f} {:>10} "
+      "{:>12.0f}\n",
+      kind, frames.size(), micros(total_time) / count, at(0.5), at(0.99),
+      micros(frames.back().time),
+      static_cast<double>(total_allocations) / count, most_allocations,
+      static_cast<double>(total_bytes) / count);
+}
+
+}  // namespace
+
+int main(int argc, const char** argv) {
+  const std::vector<std::string> args = {argv, argv + argc};
+  const std::string source = args.size() > 1 ? args[1] : "10000";
+  const int board_size = args.size() > 2 ? std::stoi(args[2]) : 15;
+
+  tictactoe::GameRules rules{board_size, board_size, std::min(board_size, 5)};
+  tictactoe::InputScript script;
+  const bool synthetic =
+      !source.empty() and
+      std::all_of(source.begin(), source.end(),
+                  [](char c) { return c >= '0' and c <= '9'; });
+  if (synthetic) {
+    const auto board_extent = tictactoe::GridLayout::extent(board_size);
+    script = tictactoe::synthetic_input_script(
+        rules, board_extent, board_extent, std::stoull(source), 16, 1);
+  } else {
+    auto read = tictactoe::read_input_script(source);
+    if (!read) {
+      fmt::print(stderr, "cannot read {}: {}\n", source,
+                 read.error().message());
+      return EXIT_FAILURE;
+    }
+    script = std::move(read).value();
+    rules = script.rules.value_or(rules);
+  }
+
+  auto created = tictactoe::Engine::create_engine(rules);
+  if (!created) {
+    fmt::print(stderr, "invalid rules {}x{}, {} to win\n", rules.rows,
+               rules.cols, rules.win_length);
+    return EXIT_FAILURE;
+  }
+  tictactoe::Engine engine = std::move(created).value();
+  tictactoe::Configuration config;
+  // like the game, next to the executable, so it runs from the build tree
+  auto asset_dir = tictactoe::MakeAssetDir(std::filesystem::path{args[0]},
+                                           std::filesystem::current_path());
+  if (!asset_dir) {
+    fmt::print(stderr, "cannot find the assets: {}\n",
+               asset_dir.error().message());
+    return EXIT_FAILURE;
+  }
+  config.asset_dir = std::move(asset_dir).value();
+  tictactoe::Grid grid{config, engine};
+
+  // the frames should show the textured marks, not the placeholders
+  while (grid.assets_loading()) {
+    grid.update_assets();
+    sf::sleep(sf::milliseconds(1));
+  }
+
+  sf::RenderTexture target;
+  if (!target.create(1024, 768)) {
+    fmt::print(stderr, "cannot create the off-screen render target\n");
+    return EXIT_FAILURE;
+  }
+  // like in the game, the whole board is in view
+  const tictactoe::Camera camera{grid.get_board_size(), 1.0f};
+  target.setView(camera.view(tictactoe::ComputeAspectPreservingViewport(
+      target.getSize(), grid.get_board_size())));
+
+  std::vector<Frame> click_frames;
+  std::vector<Frame> resize_frames;
+  std::vector<Frame> move_frames;
+  click_frames.reserve(script.events.size());
+  resize_frames.reserve(script.events.size());
+  move_frames.reserve(script.events.size());
+  std::uint64_t rejected_clicks = 0;
+  std::uint64_t games = 1;
+  bool failed = false;
+
+  const auto replay_start = Clock::now();
+  for (const auto& event : script.events) {
+    const auto allocations_before =
+        allocations.load(std::memory_order_relaxed);
+    const auto bytes_before = allocated_bytes.load(std::memory_order_relaxed);
+    const auto start = Clock::now();
+
+    if (const auto* click = std::get_if<tictactoe::ScriptedClick>(&event)) {
+      if (!grid.handle_click(sf::Vector2f{click->x, click->y})) {
+        ++rejected_clicks;
+      }
+      const bool board_full = engine.move_history().size() ==
+                              static_cast<std::size_t>(rules.num_cells());
+      // a recorded game stays over, like it did in the game
+      if (synthetic and (engine.maybe_winner() or board_full)) {
+        engine = tictactoe::Engine::create_engine(rules).value();
+        if (!grid.update_grid()) {
+          failed = true;
+        }
+        ++games;
+      }
+    } else if (const auto* resize =
+                   std::get_if<tictactoe::ScriptedResize>(&event)) {
+      // a window resize reallocates its back buffer as well
+      if (!target.create(resize->width, resize->height)) {
+        fmt::print(stderr, "cannot resize the render target to {}x{}\n",
+                   resize->width, resize->height);
+        return EXIT_FAILURE;
+      }
+      target.setView(camera.view(tictactoe::ComputeAspectPreservingViewport(
+          target.getSize(), grid.get_board_size())));
+    } else if (auto applied = apply_move(event, engine, grid); !applied) {
+      fmt::print(stderr, "cannot replay \"{}\": {}\n",
+                 tictactoe::format_event(event), applied.error().message());
+      return EXIT_FAILURE;
+    }
+
+    target.clear(sf::Color::Black);
+    grid.draw_on(target);
+    target.display();
+
+    const Frame frame{
+        Clock::now() - start,
+        allocations.load(std::memory_order_relaxed) - allocations_before,
+        allocated_bytes.load(std::memory_order_relaxed) - bytes_before};
+    if (std::holds_alternative<tictactoe::ScriptedClick>(event)) {
+      click_frames.push_back(frame);
+    } else if (std::holds_alternative<tictactoe::ScriptedResize>(event)) {
+      resize_frames.push_back(frame);
+    } else {
+      move_frames.push_back(frame);
+    }
+  }
+  const auto replay_time = Clock::now() - replay_start;
+
+  fmt::print("{} events on a {}x{} board ({} to win) in {:.1f} ms, {} games, "
+             "{} clicks rejected\n",
+             script.events.size(), rules.rows, rules.cols, rules.win_length,
+             std::chrono::duration<double, std::milli>(replay_time).count(),
+             games, rejected_clicks);
+  fmt::print("{:>8} {:>8} {:>10} {:>10} {:>10} {:>10} {:>10} {:>10} {:>12}\n",
+             "frames", "count", "avg [us]", "p50 [us]", "p99 [us]",
+             "max [us]", "allocs", "max allocs", "bytes");
+  print_summary("click", click_frames);
+  print_summary("resize", resize_frames);
+  print_summary("move", move_frames);
+  auto all_frames = click_frames;
+  all_frames.insert(all_frames.end(), resize_frames.begin(),
+                    resize_frames.end());
+  all_frames.insert(all_frames.end(), move_frames.begin(), move_frames.end());
+  print_summary("all", std::move(all_frames));
+
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,258 @@
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "bitboard_engine.hpp"
+#include "engine.hpp"
+#include "packed_board.hpp"
+
+// Differential fuzzer for the engine. The input is decoded into game rules
+// and a sequence of moves, undos and redos, which are played on Engine and
+// on a plain reference board next to it. After every step the incrementally
+// detected winner, the full-scan maybe_get_winner() and the packed fields are
+// compared with the reference; on square boards with full-line rules the
+// bitboard BasicEngine plays along as well. Any disagreement aborts.
+//
+// Input layout: rows, columns and win length (one byte each), then one byte
+// per operation: kUndo, kRedo, or the cell to select modulo the board size.
+
+namespace {
+
+using namespace tictactoe;
+
+// 15x15 keeps every cell reachable from a byte below kRedo.
+constexpr int kMaxSide = 15;
+constexpr std::uint8_t kUndo = 0xFF;
+constexpr std::uint8_t kRedo = 0xFE;
+
+void check(bool condition, const char* what) {
+  if (!condition) {
+    fmt::print(stderr, "engine mismatch: {}\n", what);
+    std::abort();
+  }
+}
+
+// What the engine should hold, kept as simply as possible: one FieldState
+// per cell, the played and undone cells, and a brute force winner.
+struct ReferenceGame {
+  GameRules rules;
+  std::vector<FieldState> cells;
+  std::vector<int> moves;
+  std::vector<int> undone;
+
+  explicit ReferenceGame(const GameRules& r)
+      : rules{r},
+        cells(static_cast<std::size_t>(r.num_cells()), FieldState::Empty) {}
+
+  FieldState at(int row, int col) const {
+    return cells[pos2idx(row, col, rules.cols)];
+  }
+
+  Player to_move() const {
+    return moves.size() % 2 == 0 ? Player::CrossPlayer : Player::CirclePlayer;
+  }
+
+  void play(int cell) {
+    cells[static_cast<std::size_t>(cell)] = to_move() == Player::CrossPlayer
+                                                ? FieldState::Cross
+                                                : FieldState::Circle;
+    moves.push_back(cell);
+  }
+
+  void take_back() {
+    cells[static_cast<std::size_t>(moves.back())] = FieldState::Empty;
+    moves.pop_back();
+  }
+
+  // Any run of win_length stones in one of the four directions.
+  std::optional<Player> winner() const {
+    constexpr int kDirections[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+    for (int row = 0; row < rules.rows; ++row) {
+      for (int col = 0; col < rules.cols; ++col) {
+        const auto state = at(row, col);
+        if (state == FieldState::Empty) {
+          continue;
+        }
+        for (const auto& d : kDirections) {
+          int run = 1;
+          int r = row + d[0];
+          int c = col + d[1];
+          while (run < rules.win_length and r >= 0 and r < rules.rows and
+                 c >= 0 and c < rules.cols and at(r, c) == state) {
+            ++run;
+            r += d[0];
+            c += d[1];
+          }
+          if (run == rules.win_length) {
+            return state == FieldState::Cross ? Player::CrossPlayer
+                                              : Player::CirclePlayer;
+          }
+        }
+      }
+    }
+    return std::nullopt;
+  }
+};
+
+void check_same(const Engine& engine, const ReferenceGame& ref) {
+  for (int row = 0; row < ref.rules.rows; ++row) {
+    for (int col = 0; col < ref.rules.cols; ++col) {
+      const auto pos =
+          Position::create_position_for_engine(row, col, engine).value();
+      check(engine.get_field_state_at(pos) == ref.at(row, col), "field");
+    }
+  }
+  const auto winner = ref.winner();
+  check(engine.maybe_winner() == winner, "incremental winner");
+  check(engine.maybe_get_winner() == winner, "full-scan winner");
+  check(engine.get_active_player() == ref.to_move(), "player to move");
+  check(engine.move_history() == ref.moves, "move history");
+  check(engine.can_undo() == !ref.moves.empty(), "can_undo");
+  check(engine.can_redo() == !ref.undone.empty(), "can_redo");
+}
+
+// The bitboard engine has no undo, so it only follows games without one.
+template <int N>
+void replay_on_bitboard(const ReferenceGame& ref) {
+  auto engine = BasicEngine<N>::create_engine().value();
+  for (const int cell : ref.moves) {
+    const auto pos =
+        Position::create_position_for_engine(cell / N, cell % N, engine)
+            .value();
+    check(engine.handle_field_selected(pos).has_value(), "bitboard move");
+  }
+  for (int row = 0; row < N; ++row) {
+    for (int col = 0; col < N; ++col) {
+      const auto pos =
+          Position::create_position_for_engine(row, col, engine).value();
+      check(engine.get_field_state_at(pos) == ref.at(row, col),
+            "bitboard field");
+    }
+  }
+  const auto winner = ref.winner();
+  check(engine.maybe_winner() == winner, "bitboard incremental winner");
+  check(engine.maybe_get_winner() == winner, "bitboard full-scan winner");
+}
+
+void replay_on_bitboard(const ReferenceGame& ref) {
+  switch (ref.rules.rows) {
+    case 3:
+      return replay_on_bitboard<3>(ref);
+    case 4:
+      return replay_on_bitboard<4>(ref);
+    case 5:
+      return replay_on_bitboard<5>(ref);
+    case 8:
+      return replay_on_bitboard<8>(ref);
+    case 9:
+      return replay_on_bitboard<9>(ref);
+    default:
+      return;
+  }
+}
+
+// Lines read through PackedBoard::line() against the cells one by one.
+void check_lines(const ReferenceGame& ref) {
+  PackedBoard board{ref.cells.size()};
+  for (std::size_t i = 0; i < ref.cells.size(); ++i) {
+    board.set(i, ref.cells[i]);
+  }
+  check(std::equal(board.begin(), board.end(), ref.cells.begin(),
+                   ref.cells.end()),
+        "packed cells");
+
+  const int cols = ref.rules.cols;
+  for (int row = 0; row < ref.rules.rows; ++row) {
+    const auto line = board.line(pos2idx(row, 0, cols), 1,
+                                 static_cast<std::size_t>(cols));
+    int col = 0;
+    for (const auto state : line) {
+      check(state == ref.at(row, col++), "packed row");
+    }
+    check(col == cols, "packed row length");
+  }
+  for (int col = 0; col < cols; ++col) {
+    // bottom to top, to walk backwards through the words
+    const auto line =
+        board.line(pos2idx(ref.rules.rows - 1, col, cols), -cols,
+                   static_cast<std::size_t>(ref.rules.rows));
+    int row = ref.rules.rows - 1;
+    for (const auto state : line) {
+      check(state == ref.at(row--, col), "packed column");
+    }
+    check(row == -1, "packed column length");
+  }
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data,
+                                      std::size_t size) {
+  if (size < 3) {
+    return 0;
+  }
+  const std::span<const std::uint8_t> input{data, size};
+  GameRules rules;
+  rules.rows = 1 + input[0] % kMaxSide;
+  rules.cols = 1 + input[1] % kMaxSide;
+  // reaches one past the longer side, which has to be rejected
+  rules.win_length = 1 + input[2] % (std::max(rules.rows, rules.cols) + 1);
+
+  auto created = Engine::create_engine(rules);
+  const bool valid =
+      rules.win_length > 1 and
+      (rules.win_length <= rules.rows or rules.win_length <= rules.cols);
+  check(created.has_value() == valid, "create_engine validation");
+  if (!created) {
+    return 0;
+  }
+  Engine engine = std::move(created).value();
+  ReferenceGame ref{rules};
+  bool undone_any = false;
+
+  for (const auto op : input.subspan(3)) {
+    if (op == kUndo) {
+      undone_any = true;
+      check(engine.undo().has_value() == !ref.moves.empty(), "undo");
+      if (!ref.moves.empty()) {
+        ref.undone.push_back(ref.moves.back());
+        ref.take_back();
+      }
+    } else if (op == kRedo) {
+      undone_any = true;
+      check(engine.redo().has_value() == !ref.undone.empty(), "redo");
+      if (!ref.undone.empty()) {
+        ref.play(ref.undone.back());
+        ref.undone.pop_back();
+      }
+    } else {
+      const int cell = op % rules.num_cells();
+      const auto pos = Position::create_position_for_engine(
+                           cell / rules.cols, cell % rules.cols, engine)
+                           .value();
+      const bool over = ref.winner().has_value();
+      const bool empty =
+          ref.cells[static_cast<std::size_t>(cell)] == FieldState::Empty;
+      // selecting anything after a win is accepted and ignored
+      check(engine.handle_field_selected(pos).has_value() == (over or empty),
+            "handle_field_selected result");
+      if (!over and empty) {
+        ref.play(cell);
+        ref.undone.clear();
+      }
+    }
+    check_same(engine, ref);
+  }
+
+  check_lines(ref);
+  if (rules.is_full_line() and !undone_any) {
+    replay_on_bitboard(ref);
+  }
+  return 0;
+}
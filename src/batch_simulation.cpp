@@ -0,0 +1,194 @@
+#include "batch_simulation.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace tictactoe {
+
+namespace {
+
+// Games a thread has encoded are appended to the file once they reach this
+// many bytes.
+constexpr std::size_t kRecordBufferBytes = 64 * 1024;
+
+// The writer shared by all threads, and the first error writing to it.
+struct RecordSink {
+  GameRecordWriter& writer;
+  std::mutex mutex;
+  std::error_code error;
+};
+
+std::mt19937_64 make_rng(std::uint64_t seed, unsigned thread_index) {
+  std::seed_seq seq{static_cast<std::uint32_t>(seed),
+                    static_cast<std::uint32_t>(seed >> 32U), thread_index};
+  return std::mt19937_64{seq};
+}
+
+// Everything one thread needs to play games without sharing state.
+class SimulationWorker {
+ public:
+  SimulationWorker(const SimulationOptions& options, const Engine& initial,
+                   unsigned thread_index, RecordSink* sink)
+      : options_{options},
+        initial_{initial},
+        engine_{initial},
+        rng_{make_rng(options.seed, thread_index)},
+        empty_cells_(static_cast<std::size_t>(options.rules.num_cells())),
+        sink_{sink} {
+    if (options.players == SimulatedPlayer::Negamax) {
+      ai_.emplace(options.rules, options.search_limits, 18);
+    }
+  }
+
+  void play_games(std::uint64_t count) {
+    for (std::uint64_t game = 0; game < count; ++game) {
+      play_game();
+    }
+    flush_records();
+  }
+
+  SimulationResult& result() { return result_; }
+
+ private:
+  const SimulationOptions& options_;
+  const Engine& initial_;
+  Engine engine_;
+  std::mt19937_64 rng_;
+  std::vector<int> empty_cells_;
+  std::optional<NegamaxPlayer> ai_;
+  RecordSink* sink_;
+  GameRecord record_;
+  std::vector<std::uint8_t> records_;
+  SimulationResult result_;
+
+  void flush_records() {
+    if (records_.empty()) {
+      return;
+    }
+    const std::lock_guard lock{sink_->mutex};
+    if (!sink_->error) {
+      auto written = sink_->writer.append_encoded(records_);
+      if (!written) {
+        sink_->error = written.error();
+      }
+    }
+    records_.clear();
+  }
+
+  void play_game() {
+    // copy-assignment reuses the buffers of the previous game
+    engine_ = initial_;
+    // cells still free are kept in empty_cells_[0, free)
+    std::iota(empty_cells_.begin(), empty_cells_.end(), 0);
+    std::size_t free = empty_cells_.size();
+    record_.rules = options_.rules;
+    record_.moves.clear();
+
+    int ply = 0;
+    while (free > 0 and !engine_.maybe_winner()) {
+      std::size_t slot = 0;
+      if (ai_ and ply >= options_.random_opening_moves) {
+        const auto move = ai_->choose_move(engine_).value();
+        const int cell = static_cast<int>(
+            pos2idx(move.row(), move.col(), options_.rules.cols));
+        slot = static_cast<std::size_t>(
+            std::find(empty_cells_.begin(),
+                      empty_cells_.begin() + static_cast<std::ptrdiff_t>(free),
+                      cell) -
+            empty_cells_.begin());
+      } else {
+        slot = std::uniform_int_distribution<std::size_t>{0, free - 1}(rng_);
+      }
+
+      (void)engine_.handle_field_selected(
+          engine_.position_of(empty_cells_[slot]));
+      if (sink_ != nullptr) {
+        record_.moves.push_back(empty_cells_[slot]);
+      }
+      std::swap(empty_cells_[slot], empty_cells_[--free]);
+      ++ply;
+    }
+
+    if (sink_ != nullptr) {
+      game_record::encode(record_, records_);
+      if (records_.size() >= kRecordBufferBytes) {
+        flush_records();
+      }
+    }
+    ++result_.games;
+    result_.moves += static_cast<std::uint64_t>(ply);
+    if (const auto winner = engine_.maybe_winner()) {
+      ++(*winner == Player::CrossPlayer ? result_.cross_wins
+                                        : result_.circle_wins);
+    } else {
+      ++result_.draws;
+    }
+  }
+};
+
+}  // namespace
+
+outcome::result<SimulationResult> RunSimulation(
+    const SimulationOptions& options, GameRecordWriter* records) {
+  const Engine initial = OUTCOME_TRYX(Engine::create_engine(options.rules));
+  if (options.random_opening_moves < 0 or
+      (records != nullptr and records->rules() != options.rules)) {
+    return std::errc::invalid_argument;
+  }
+  std::optional<RecordSink> sink;
+  if (records != nullptr) {
+    sink.emplace(*records);
+  }
+
+  const unsigned threads =
+      options.threads > 0 ? options.threads
+                          : std::max(1U, std::thread::hardware_concurrency());
+
+  std::vector<SimulationWorker> workers;
+  workers.reserve(threads);
+  for (unsigned t = 0; t < threads; ++t) {
+    workers.emplace_back(options, initial, t, sink ? &*sink : nullptr);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  auto games_for = [&](unsigned t) {
+    return options.games / threads + (t < options.games % threads ? 1U : 0U);
+  };
+
+  std::vector<std::thread> pool;
+  for (unsigned t = 1; t < threads; ++t) {
+    pool.emplace_back([&, t] { workers[t].play_games(games_for(t)); });
+  }
+  workers[0].play_games(games_for(0));
+  for (auto& t : pool) {
+    t.join();
+  }
+
+  SimulationResult result;
+  result.threads = threads;
+  result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+  for (auto& worker : workers) {
+    auto& partial = worker.result();
+    result.games += partial.games;
+    result.cross_wins += partial.cross_wins;
+    result.circle_wins += partial.circle_wins;
+    result.draws += partial.draws;
+    result.moves += partial.moves;
+  }
+  if (sink) {
+    if (sink->error) {
+      return sink->error;
+    }
+    OUTCOME_TRYV(records->flush());
+  }
+  return result;
+}
+
+}  // namespace tictactoe
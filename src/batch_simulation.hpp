@@ -0,0 +1,66 @@
+#ifndef TICTACTOE_BATCH_SIMULATION_H_
+#define TICTACTOE_BATCH_SIMULATION_H_
+
+#include <chrono>
+#include <cstdint>
+#include <outcome.hpp>
+
+#include "board.hpp"
+#include "game_record.hpp"
+#include "negamax_player.hpp"
+
+namespace tictactoe {
+
+enum class SimulatedPlayer {
+  // Uniformly random legal moves.
+  Random,
+  // NegamaxPlayer on both sides, after a few random opening moves.
+  Negamax,
+};
+
+struct SimulationOptions {
+  GameRules rules;
+  std::uint64_t games = 1000;
+  SimulatedPlayer players = SimulatedPlayer::Random;
+  // 0 uses std::thread::hardware_concurrency().
+  unsigned threads = 0;
+  std::uint64_t seed = 1;
+  // Random moves played before the computer players take over; without them
+  // every game between two deterministic searchers would be the same.
+  int random_opening_moves = 2;
+  SearchLimits search_limits{std::chrono::milliseconds{1000}, 3};
+};
+
+struct SimulationResult {
+  std::uint64_t games = 0;
+  std::uint64_t cross_wins = 0;
+  std::uint64_t circle_wins = 0;
+  std::uint64_t draws = 0;
+  std::uint64_t moves = 0;
+  unsigned threads = 1;
+  std::chrono::microseconds elapsed{0};
+
+  double games_per_second() const {
+    const auto us = static_cast<double>(elapsed.count());
+    return us > 0.0 ? static_cast<double>(games) * 1e6 / us : 0.0;
+  }
+};
+
+// Plays options.games complete games headlessly. The games are split evenly
+// between the threads; every thread owns its engine, random number generator
+// and search. With random players the result depends only on the options;
+// so it does with computer players as long as every search ends at
+// search_limits.max_depth, but searches cut short by the time budget depend
+// on how loaded the machine is.
+//
+// With a records writer, which has to be for options.rules, every game is
+// appended to it as well. Each thread collects its games in a small buffer
+// and appends the buffer whenever it fills up, so memory stays bounded and
+// the file grows as the simulation runs; the order of the games between
+// threads is not deterministic.
+outcome::result<SimulationResult> RunSimulation(
+    const SimulationOptions& options, GameRecordWriter* records = nullptr);
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_BATCH_SIMULATION_H_
@@ -0,0 +1,195 @@
+#ifndef TICTACTOE_BITBOARD_ENGINE_H_
+#define TICTACTOE_BITBOARD_ENGINE_H_
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <system_error>
+
+#include "board.hpp"
+
+namespace tictactoe {
+
+// Set of cells of an N x N board, one bit per cell in row-major order
+// (see pos2idx). Boards larger than 8x8 spill over into further words.
+template <int N>
+struct Bitboard {
+  static_assert(N > 1, "board must be at least 2x2");
+
+  static constexpr std::size_t num_cells = static_cast<std::size_t>(N * N);
+  static constexpr std::size_t bits_per_word = 64;
+  static constexpr std::size_t num_words =
+      (num_cells + bits_per_word - 1) / bits_per_word;
+
+  std::array<std::uint64_t, num_words> words{};
+
+  constexpr void set(std::size_t idx) {
+    words[idx / bits_per_word] |= std::uint64_t{1} << (idx % bits_per_word);
+  }
+
+  constexpr bool test(std::size_t idx) const {
+    return (words[idx / bits_per_word] >> (idx % bits_per_word)) & 1U;
+  }
+
+  // True if every cell of mask is also set in this board.
+  constexpr bool contains(const Bitboard& mask) const {
+    for (std::size_t i = 0; i < num_words; ++i) {
+      if ((words[i] & mask.words[i]) != mask.words[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  constexpr std::size_t count() const {
+    std::size_t total = 0;
+    for (const auto w : words) {
+      total += static_cast<std::size_t>(std::popcount(w));
+    }
+    return total;
+  }
+
+  constexpr bool operator==(const Bitboard&) const = default;
+};
+
+// Winning lines of an N x N board: rows first, then columns, then the
+// diagonal and the antidiagonal.
+template <int N>
+constexpr std::size_t num_lines = static_cast<std::size_t>(2 * N + 2);
+
+template <int N>
+constexpr std::size_t row_line(int row) {
+  return static_cast<std::size_t>(row);
+}
+
+template <int N>
+constexpr std::size_t column_line(int col) {
+  return static_cast<std::size_t>(N + col);
+}
+
+template <int N>
+constexpr std::size_t diagonal_line = static_cast<std::size_t>(2 * N);
+
+template <int N>
+constexpr std::size_t antidiagonal_line = static_cast<std::size_t>(2 * N + 1);
+
+template <int N>
+constexpr std::array<Bitboard<N>, num_lines<N>> make_line_masks() {
+  std::array<Bitboard<N>, num_lines<N>> masks{};
+  for (int i = 0; i < N; ++i) {
+    for (int j = 0; j < N; ++j) {
+      masks[row_line<N>(i)].set(pos2idx(i, j, N));
+      masks[column_line<N>(i)].set(pos2idx(j, i, N));
+    }
+    masks[diagonal_line<N>].set(pos2idx(i, i, N));
+    masks[antidiagonal_line<N>].set(pos2idx(i, N - 1 - i, N));
+  }
+  return masks;
+}
+
+template <int N>
+constexpr auto line_masks = make_line_masks<N>();
+
+// Engine with the board size fixed at compile time. Each player's stones are
+// kept in a Bitboard and wins are detected by matching the precomputed line
+// masks, so no per-cell branching or heap access is needed. Offers the same
+// interface as Engine.
+template <int N>
+class BasicEngine {
+  Bitboard<N> circles_;
+  Bitboard<N> crosses_;
+  Player active_player_ = Player::CrossPlayer;
+  std::optional<Player> winner_ = std::nullopt;
+
+  constexpr const Bitboard<N>& stones_of(Player p) const {
+    return p == Player::CirclePlayer ? circles_ : crosses_;
+  }
+
+  constexpr Bitboard<N>& stones_of(Player p) {
+    return p == Player::CirclePlayer ? circles_ : crosses_;
+  }
+
+  constexpr bool has_line_through(const Bitboard<N>& stones,
+                                  const Position& pos) const {
+    const auto& masks = line_masks<N>;
+    if (stones.contains(masks[row_line<N>(pos.row())]) or
+        stones.contains(masks[column_line<N>(pos.col())])) {
+      return true;
+    }
+    if (pos.row() == pos.col() and
+        stones.contains(masks[diagonal_line<N>])) {
+      return true;
+    }
+    return pos.row() + pos.col() == N - 1 and
+           stones.contains(masks[antidiagonal_line<N>]);
+  }
+
+ public:
+  static outcome::result<BasicEngine> create_engine() { return BasicEngine{}; }
+
+  constexpr int board_size() const { return N; }
+  constexpr int rows() const { return N; }
+  constexpr int cols() const { return N; }
+  constexpr GameRules rules() const { return GameRules::square(N); }
+  constexpr Player get_active_player() const { return active_player_; }
+  constexpr std::optional<Player> maybe_winner() const { return winner_; }
+
+  constexpr const Bitboard<N>& circles() const { return circles_; }
+  constexpr const Bitboard<N>& crosses() const { return crosses_; }
+
+  // Full scan over all lines; handle_field_selected only checks the lines
+  // through the last move.
+  constexpr std::optional<Player> maybe_get_winner() const {
+    for (const auto& mask : line_masks<N>) {
+      if (circles_.contains(mask)) {
+        return Player::CirclePlayer;
+      }
+      if (crosses_.contains(mask)) {
+        return Player::CrossPlayer;
+      }
+    }
+    return std::nullopt;
+  }
+
+  constexpr FieldState get_field_state_at(const Position& pos) const {
+    const auto idx = pos2idx(pos.row(), pos.col(), N);
+    if (circles_.test(idx)) {
+      return FieldState::Circle;
+    }
+    if (crosses_.test(idx)) {
+      return FieldState::Cross;
+    }
+    return FieldState::Empty;
+  }
+
+  constexpr Player next_player() const {
+    return active_player_ == Player::CrossPlayer ? Player::CirclePlayer
+                                                 : Player::CrossPlayer;
+  }
+
+  outcome::result<void> handle_field_selected(const Position& pos) {
+    if (winner_) {
+      return outcome::success();
+    }
+
+    if (get_field_state_at(pos) != FieldState::Empty) {
+      return outcome::failure(std::errc::invalid_argument);
+    }
+
+    auto& stones = stones_of(active_player_);
+    stones.set(pos2idx(pos.row(), pos.col(), N));
+    if (has_line_through(stones, pos)) {
+      winner_ = active_player_;
+    }
+
+    active_player_ = next_player();
+
+    return outcome::success();
+  }
+};
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_BITBOARD_ENGINE_H_
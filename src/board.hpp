@@ -0,0 +1,91 @@
+#ifndef TICTACTOE_BOARD_H_
+#define TICTACTOE_BOARD_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <outcome.hpp>
+#include <system_error>
+#include <tuple>
+
+namespace tictactoe {
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+constexpr std::size_t pos2idx(int row, int column, int grid_size) {
+  return static_cast<std::size_t>(column + row * grid_size);
+}
+
+constexpr std::tuple<int, int> idx2pos(std::size_t index, int grid_size) {
+  const auto x = static_cast<int>(index) % grid_size;
+  const auto y = static_cast<int>(index) / grid_size;
+  return std::make_tuple(x, y);
+}
+
+enum class Player {
+  CirclePlayer,
+  CrossPlayer,
+};
+
+// Fits in two bits; Engine stores boards packed that way (see PackedBoard).
+enum class FieldState : std::uint8_t {
+  Empty,
+  Circle,
+  Cross,
+};
+
+// Board dimensions and the number of stones in a row needed to win, as in
+// an m,n,k-game. Classic tic-tac-toe is {n, n, n}; gomoku is {15, 15, 5}.
+struct GameRules {
+  int rows = 3;
+  int cols = 3;
+  int win_length = 3;
+
+  static constexpr GameRules square(int board_size) {
+    return GameRules{board_size, board_size, board_size};
+  }
+
+  constexpr int num_cells() const { return rows * cols; }
+
+  // Only complete rows, columns and main diagonals win.
+  constexpr bool is_full_line() const {
+    return rows == cols and win_length == rows;
+  }
+
+  constexpr bool operator==(const GameRules&) const = default;
+};
+
+// A board coordinate that has been validated against a particular engine.
+// Works with any engine type exposing rows() and cols().
+class Position {
+  int row_;
+  int col_;
+
+  constexpr Position(int row, int col) : row_{row}, col_{col} {}
+
+ public:
+  template <typename EngineT>
+  static outcome::result<Position> create_position_for_engine(
+      std::tuple<int, int> p, const EngineT& e) {
+    return create_position_for_engine(std::get<0>(p), std::get<1>(p), e);
+  }
+
+  template <typename EngineT>
+  static outcome::result<Position> create_position_for_engine(
+      int row, int col, const EngineT& engine) {
+    if (row < 0 or row >= engine.rows()) {
+      return std::errc::argument_out_of_domain;
+    }
+    if (col < 0 or col >= engine.cols()) {
+      return std::errc::argument_out_of_domain;
+    }
+
+    return Position(row, col);
+  }
+
+  constexpr int row() const { return row_; }
+  constexpr int col() const { return col_; }
+};
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_BOARD_H_
@@ -0,0 +1,184 @@
+#include "board_batch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+
+#include "win_lines.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TICTACTOE_X86_SIMD 1
+// The kernel has to be inlined into the functions compiled for SSE2 and AVX2
+// to be compiled for them.
+#define TICTACTOE_KERNEL [[gnu::always_inline]] inline
+#else
+#define TICTACTOE_KERNEL inline
+#endif
+
+namespace tictactoe {
+
+namespace {
+
+// ANDing the states of a segment keeps the circle bit only if every field
+// holds a circle, and likewise for crosses.
+constexpr auto kCircleBit = static_cast<std::uint8_t>(FieldState::Circle);
+constexpr auto kCrossBit = static_cast<std::uint8_t>(FieldState::Cross);
+static_assert((kCircleBit & kCrossBit) == 0 and
+              static_cast<std::uint8_t>(FieldState::Empty) == 0);
+
+#if TICTACTOE_X86_SIMD
+// GCC and Clang vector extensions; the element-wise operators compile to
+// SSE2 or AVX2 instructions depending on the target of the function using
+// them.
+using Bytes16 = std::uint8_t __attribute__((vector_size(16)));
+using Bytes32 = std::uint8_t __attribute__((vector_size(32)));
+#endif
+
+// Vectors are only passed by reference: their calling convention differs
+// between code compiled with and without AVX.
+template <typename V>
+TICTACTOE_KERNEL void splat(V& v, std::uint8_t byte) {
+  std::memset(&v, byte, sizeof v);
+}
+
+template <typename V>
+TICTACTOE_KERNEL void load(V& v, const FieldState* cells) {
+  std::memcpy(&v, cells, sizeof v);
+}
+
+BoardStatus classify(std::uint8_t wins, bool filled) {
+  const bool cross = (wins & kCrossBit) != 0;
+  const bool circle = (wins & kCircleBit) != 0;
+  if (cross and circle) {
+    return BoardStatus::Invalid;
+  }
+  if (cross) {
+    return BoardStatus::CrossWon;
+  }
+  if (circle) {
+    return BoardStatus::CircleWon;
+  }
+  return filled ? BoardStatus::Draw : BoardStatus::Ongoing;
+}
+
+// What every level shares: the cell offsets of the winning segments, k per
+// segment, already multiplied by the stride.
+struct Kernel {
+  const BoardBatch& batch;
+  std::vector<std::size_t> segments;
+  std::size_t win_length;
+  BoardStatus* out;
+
+  // Evaluates sizeof(V) boards at a time, one byte per board: a segment is
+  // the AND of its fields, the wins the OR of all segments, and a board is
+  // filled if no field is zero.
+  template <typename V>
+  TICTACTOE_KERNEL void run() const {
+    constexpr std::size_t kWidth = sizeof(V);
+    const FieldState* cells = batch.data();
+    const std::size_t stride = batch.stride();
+    const auto num_cells = static_cast<std::size_t>(batch.rules().num_cells());
+    V ones;
+    splat(ones, 1);
+
+    for (std::size_t board = 0; board < batch.size(); board += kWidth) {
+      V wins;
+      splat(wins, 0);
+      for (std::size_t s = 0; s < segments.size(); s += win_length) {
+        V line;
+        load(line, cells + segments[s] + board);
+        for (std::size_t i = 1; i < win_length; ++i) {
+          V v;
+          load(v, cells + segments[s + i] + board);
+          line &= v;
+        }
+        wins |= line;
+      }
+
+      V filled = ones;
+      for (std::size_t cell = 0; cell < num_cells; ++cell) {
+        V v;
+        load(v, cells + cell * stride + board);
+        filled &= (v | (v >> 1)) & ones;
+      }
+
+      std::array<std::uint8_t, kWidth> win_bytes;
+      std::array<std::uint8_t, kWidth> filled_bytes;
+      std::memcpy(win_bytes.data(), &wins, kWidth);
+      std::memcpy(filled_bytes.data(), &filled, kWidth);
+      const std::size_t count = std::min(kWidth, batch.size() - board);
+      for (std::size_t i = 0; i < count; ++i) {
+        out[board + i] = classify(win_bytes[i], filled_bytes[i] != 0);
+      }
+    }
+  }
+};
+
+#if TICTACTOE_X86_SIMD
+__attribute__((target("sse2"))) void run_sse2(const Kernel& kernel) {
+  kernel.run<Bytes16>();
+}
+
+__attribute__((target("avx2"))) void run_avx2(const Kernel& kernel) {
+  kernel.run<Bytes32>();
+}
+#endif
+
+}  // namespace
+
+SimdLevel best_simd_level() {
+#if TICTACTOE_X86_SIMD
+  if (__builtin_cpu_supports("avx2")) {
+    return SimdLevel::Avx2;
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    return SimdLevel::Sse2;
+  }
+#endif
+  return SimdLevel::Scalar;
+}
+
+BoardBatch::BoardBatch(const GameRules& rules, std::size_t boards)
+    : rules_{rules},
+      boards_{boards},
+      stride_{(boards + kAlignment - 1) / kAlignment * kAlignment},
+      cells_(static_cast<std::size_t>(rules.num_cells()) * stride_,
+             FieldState::Empty) {
+  assert(rules.win_length >= 1);
+}
+
+void BoardBatch::store(std::size_t board, const Engine& engine) {
+  for (int row = 0; row < rules_.rows; ++row) {
+    for (int col = 0; col < rules_.cols; ++col) {
+      const auto pos =
+          Position::create_position_for_engine(row, col, engine).value();
+      set(board, static_cast<int>(pos2idx(row, col, rules_.cols)),
+          engine.get_field_state_at(pos));
+    }
+  }
+}
+
+void evaluate(const BoardBatch& batch, std::span<BoardStatus> out,
+              SimdLevel level) {
+  assert(out.size() >= batch.size());
+  Kernel kernel{batch, {}, static_cast<std::size_t>(batch.rules().win_length),
+                out.data()};
+  for (const int cell : winning_segments(batch.rules())) {
+    kernel.segments.push_back(static_cast<std::size_t>(cell) *
+                              batch.stride());
+  }
+
+  switch (std::min(level, best_simd_level())) {
+#if TICTACTOE_X86_SIMD
+    case SimdLevel::Avx2:
+      return run_avx2(kernel);
+    case SimdLevel::Sse2:
+      return run_sse2(kernel);
+#endif
+    default:
+      return kernel.run<std::uint64_t>();
+  }
+}
+
+}  // namespace tictactoe
@@ -0,0 +1,82 @@
+#ifndef TICTACTOE_BOARD_BATCH_H_
+#define TICTACTOE_BOARD_BATCH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "board.hpp"
+#include "engine.hpp"
+
+namespace tictactoe {
+
+enum class BoardStatus : std::uint8_t {
+  Ongoing,
+  CrossWon,
+  CircleWon,
+  // Every field is taken and nobody has a winning line.
+  Draw,
+  // Both players have a winning line, which no game can reach.
+  Invalid,
+};
+
+// Instruction sets evaluate() can use; each one includes the ones before.
+enum class SimdLevel {
+  // Eight boards per 64-bit word, portable to every platform.
+  Scalar,
+  Sse2,
+  Avx2,
+};
+
+// The best level the running CPU supports.
+SimdLevel best_simd_level();
+
+// Many boards of the same rules in structure-of-arrays layout: the states of
+// one cell on all boards are contiguous, so a line check runs over a whole
+// vector of boards at once. The board count is padded with empty boards to
+// a multiple of kAlignment.
+class BoardBatch {
+ public:
+  static constexpr std::size_t kAlignment = 32;
+
+  // All boards start out empty; rules as accepted by Engine::create_engine.
+  BoardBatch(const GameRules& rules, std::size_t boards);
+
+  const GameRules& rules() const { return rules_; }
+  std::size_t size() const { return boards_; }
+  // Distance between the same board in consecutive cells.
+  std::size_t stride() const { return stride_; }
+
+  FieldState at(std::size_t board, int cell) const {
+    return cells_[index(board, cell)];
+  }
+  void set(std::size_t board, int cell, FieldState state) {
+    cells_[index(board, cell)] = state;
+  }
+  // Copies the fields of engine, which has to play by rules(), into board.
+  void store(std::size_t board, const Engine& engine);
+
+  // Cell c of board b is at data()[c * stride() + b].
+  const FieldState* data() const { return cells_.data(); }
+
+ private:
+  std::size_t index(std::size_t board, int cell) const {
+    return static_cast<std::size_t>(cell) * stride_ + board;
+  }
+
+  GameRules rules_;
+  std::size_t boards_;
+  std::size_t stride_;
+  std::vector<FieldState> cells_;
+};
+
+// Classifies every board of batch into out, which needs batch.size() entries.
+// All winning segments are checked on every board without branching on the
+// fields; level is lowered to what the CPU supports.
+void evaluate(const BoardBatch& batch, std::span<BoardStatus> out,
+              SimdLevel level = best_simd_level());
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_BOARD_BATCH_H_
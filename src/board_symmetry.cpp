@@ -0,0 +1,118 @@
+#include "board_symmetry.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <tuple>
+#include <utility>
+
+namespace tictactoe {
+
+BoardSymmetry::BoardSymmetry(int board_size)
+    : size_{board_size},
+      cells_{board_size * board_size},
+      forward_(static_cast<std::size_t>(kNumTransforms * cells_)),
+      inverse_(forward_.size()) {
+  for (int t = 0; t < kNumTransforms; ++t) {
+    for (int row = 0; row < size_; ++row) {
+      for (int col = 0; col < size_; ++col) {
+        int r = row;
+        int c = t >= 4 ? size_ - 1 - col : col;  // mirror first
+        for (int quarter = 0; quarter < t % 4; ++quarter) {
+          std::tie(r, c) = std::pair{c, size_ - 1 - r};  // rotate clockwise
+        }
+        const auto from = static_cast<int>(pos2idx(row, col, size_));
+        const auto to = static_cast<int>(pos2idx(r, c, size_));
+        forward_[index(t, from)] = to;
+        inverse_[index(t, to)] = from;
+      }
+    }
+  }
+
+  if (cells_ > kMaxPackedCells) {
+    return;
+  }
+  packed_bytes_ = static_cast<std::size_t>((cells_ + 3) / 4);
+  packed_.resize(kNumTransforms * packed_bytes_);
+  for (int t = 0; t < kNumTransforms; ++t) {
+    for (std::size_t byte = 0; byte < packed_bytes_; ++byte) {
+      auto& table = packed_[static_cast<std::size_t>(t) * packed_bytes_ + byte];
+      for (unsigned value = 0; value < 256; ++value) {
+        std::uint64_t result = 0;
+        for (unsigned i = 0; i < 4; ++i) {
+          // byte b holds bits [8b, 8b + 8) of the key
+          const unsigned bit = 8U * static_cast<unsigned>(byte) + 2U * i;
+          const auto cell = cells_ - 1 - static_cast<int>(bit / 2U);
+          const std::uint64_t state = (value >> (2U * i)) & 3U;
+          if (cell >= 0 and state != 0) {
+            result |= state << packed_shift(map_cell(t, cell));
+          }
+        }
+        table[value] = result;
+      }
+    }
+  }
+}
+
+CanonicalBoard BoardSymmetry::canonicalize(
+    std::span<const FieldState> fields) const {
+  assert(fields.size() == static_cast<std::size_t>(cells_));
+  CanonicalBoard best{{fields.begin(), fields.end()}, 0};
+  std::vector<FieldState> candidate(fields.size());
+  for (int t = 1; t < kNumTransforms; ++t) {
+    for (int cell = 0; cell < cells_; ++cell) {
+      candidate[static_cast<std::size_t>(map_cell(t, cell))] =
+          fields[static_cast<std::size_t>(cell)];
+    }
+    if (candidate < best.fields) {
+      std::swap(best.fields, candidate);
+      best.transform = t;
+    }
+  }
+  return best;
+}
+
+CanonicalBoard BoardSymmetry::canonicalize(const Engine& engine) const {
+  assert(engine.rows() == size_ and engine.cols() == size_);
+  std::vector<FieldState> fields;
+  fields.reserve(static_cast<std::size_t>(cells_));
+  for (int row = 0; row < size_; ++row) {
+    for (int col = 0; col < size_; ++col) {
+      fields.push_back(engine.get_field_state_at(
+          Position::create_position_for_engine(row, col, engine).value()));
+    }
+  }
+  return canonicalize(fields);
+}
+
+std::uint64_t BoardSymmetry::pack(std::span<const FieldState> fields) const {
+  assert(cells_ <= kMaxPackedCells);
+  std::uint64_t key = 0;
+  for (int cell = 0; cell < cells_; ++cell) {
+    key |= static_cast<std::uint64_t>(fields[static_cast<std::size_t>(cell)])
+           << packed_shift(cell);
+  }
+  return key;
+}
+
+std::uint64_t BoardSymmetry::transform_packed(int t, std::uint64_t key) const {
+  assert(cells_ <= kMaxPackedCells);
+  const auto* tables = &packed_[static_cast<std::size_t>(t) * packed_bytes_];
+  std::uint64_t result = 0;
+  for (std::size_t byte = 0; byte < packed_bytes_; ++byte) {
+    result |= tables[byte][(key >> (8U * byte)) & 0xFFU];
+  }
+  return result;
+}
+
+CanonicalKey BoardSymmetry::canonicalize_packed(std::uint64_t key) const {
+  CanonicalKey best{key, 0};
+  for (int t = 1; t < kNumTransforms; ++t) {
+    const auto transformed = transform_packed(t, key);
+    if (transformed < best.key) {
+      best = CanonicalKey{transformed, t};
+    }
+  }
+  return best;
+}
+
+}  // namespace tictactoe
@@ -0,0 +1,84 @@
+#ifndef TICTACTOE_BOARD_SYMMETRY_H_
+#define TICTACTOE_BOARD_SYMMETRY_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "board.hpp"
+#include "engine.hpp"
+
+namespace tictactoe {
+
+// A board brought into its canonical orientation: the least (field by field,
+// in pos2idx order) of its eight rotations and reflections.
+struct CanonicalBoard {
+  std::vector<FieldState> fields;
+  // Transform taking the original board to fields; BoardSymmetry::unmap_cell
+  // with it takes cells of the canonical board back to the original.
+  int transform = 0;
+};
+
+// Same as CanonicalBoard for boards packed into an integer by
+// BoardSymmetry::pack.
+struct CanonicalKey {
+  std::uint64_t key = 0;
+  int transform = 0;
+};
+
+// The dihedral symmetries of a square board, as precomputed cell
+// permutations. Transform 0 is the identity, 1-3 rotate clockwise by 90, 180
+// and 270 degrees, and 4-7 mirror left-right before rotating the same way.
+class BoardSymmetry {
+ public:
+  static constexpr int kNumTransforms = 8;
+  // pack() needs 2 bits per cell.
+  static constexpr int kMaxPackedCells = 32;
+
+  explicit BoardSymmetry(int board_size);
+
+  int board_size() const { return size_; }
+  int num_cells() const { return cells_; }
+
+  // Cell that transform t moves cell to.
+  int map_cell(int t, int cell) const { return forward_[index(t, cell)]; }
+  // Cell that transform t moves to cell.
+  int unmap_cell(int t, int cell) const { return inverse_[index(t, cell)]; }
+
+  CanonicalBoard canonicalize(std::span<const FieldState> fields) const;
+  // The engine has to be square and board_size() wide.
+  CanonicalBoard canonicalize(const Engine& engine) const;
+
+  // Boards of up to kMaxPackedCells cells as 2 bits per cell (the value of
+  // FieldState), cell 0 in the most significant position so that packed
+  // keys compare like the boards they encode.
+  std::uint64_t pack(std::span<const FieldState> fields) const;
+  unsigned packed_shift(int cell) const {
+    return 2U * static_cast<unsigned>(cells_ - 1 - cell);
+  }
+  std::uint64_t transform_packed(int t, std::uint64_t key) const;
+  CanonicalKey canonicalize_packed(std::uint64_t key) const;
+
+ private:
+  // Packed keys are transformed one byte (four cells) at a time.
+  using ByteTable = std::array<std::uint64_t, 256>;
+
+  int size_;
+  int cells_;
+  std::vector<int> forward_;
+  std::vector<int> inverse_;
+  // packed_[t * bytes + b][v]: the transformed contribution of byte b
+  // holding value v, for boards that can be packed.
+  std::vector<ByteTable> packed_;
+  std::size_t packed_bytes_ = 0;
+
+  std::size_t index(int t, int cell) const {
+    return static_cast<std::size_t>(t * cells_ + cell);
+  }
+};
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_BOARD_SYMMETRY_H_
@@ -0,0 +1,62 @@
+#include "camera.hpp"
+
+#include <algorithm>
+
+namespace tictactoe {
+
+Camera::Camera(sf::Vector2f board_size, float min_visible)
+    : board_size_{board_size},
+      max_zoom_{std::max(1.0f, std::min(board_size.x, board_size.y) /
+                                   min_visible)},
+      center_{board_size * 0.5f} {}
+
+sf::View Camera::view(const sf::FloatRect& viewport) const {
+  sf::View v;
+  v.setSize(board_size_ / zoom_);
+  v.setCenter(center_);
+  v.setViewport(viewport);
+  return v;
+}
+
+void Camera::zoom_at(sf::Vector2f anchor, float factor) {
+  const float zoom = std::clamp(zoom_ * factor, 1.0f, max_zoom_);
+  // the anchor keeps its distance from the centre in screen units
+  center_ = anchor + (center_ - anchor) * (zoom_ / zoom);
+  zoom_ = zoom;
+  clamp_center();
+}
+
+void Camera::pan(sf::Vector2f delta) {
+  center_ += delta;
+  clamp_center();
+}
+
+void Camera::reset() {
+  zoom_ = 1.0f;
+  center_ = board_size_ * 0.5f;
+}
+
+void Camera::clamp_center() {
+  const auto half = board_size_ / (2.0f * zoom_);
+  center_.x = std::clamp(center_.x, half.x, board_size_.x - half.x);
+  center_.y = std::clamp(center_.y, half.y, board_size_.y - half.y);
+}
+
+sf::FloatRect ComputeAspectPreservingViewport(const sf::Vector2u& screen_size,
+                                              const sf::Vector2f& content_size) {
+  const float screen_aspect =
+      static_cast<float>(screen_size.x) / static_cast<float>(screen_size.y);
+  const float content_aspect = content_size.x / content_size.y;
+
+  if (screen_aspect >= content_aspect) {
+    const float width = content_aspect / screen_aspect;
+    const float left_margin = (1.0f - width) * 0.5f;
+    return sf::FloatRect{left_margin, 0.0f, width, 1.0f};
+  }
+
+  const float height = screen_aspect / content_aspect;
+  const float top_margin = (1.0f - height) * 0.5f;
+  return sf::FloatRect{0.0f, top_margin, 1.0f, height};
+}
+
+}  // namespace tictactoe
@@ -0,0 +1,46 @@
+#ifndef TICTACTOE_CAMERA_H_
+#define TICTACTOE_CAMERA_H_
+
+#include <SFML/Graphics.hpp>
+
+namespace tictactoe {
+
+// The part of the board a window shows. It starts out fitting the whole
+// board; zooming in shows a smaller part of it with the same aspect ratio,
+// which can be panned around but never leaves the board.
+class Camera {
+ public:
+  // Zooming in stops once min_visible world units are left along the
+  // shorter side of the board.
+  Camera(sf::Vector2f board_size, float min_visible);
+
+  sf::View view(const sf::FloatRect& viewport) const;
+
+  // Zooms in (factor > 1) or out keeping the world point anchor where it is
+  // on the screen, e.g. the point under the mouse cursor.
+  void zoom_at(sf::Vector2f anchor, float factor);
+  // Moves the shown part of the board by delta world units.
+  void pan(sf::Vector2f delta);
+  // Fits the whole board again.
+  void reset();
+
+  float zoom() const { return zoom_; }
+  float max_zoom() const { return max_zoom_; }
+
+ private:
+  void clamp_center();
+
+  sf::Vector2f board_size_;
+  float max_zoom_;
+  float zoom_ = 1.0f;
+  sf::Vector2f center_;
+};
+
+// The part of a screen_size window that shows content_size as large as
+// possible without distorting it, centred with margins on two sides.
+sf::FloatRect ComputeAspectPreservingViewport(const sf::Vector2u& screen_size,
+                                              const sf::Vector2f& content_size);
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_CAMERA_H_
@@ -0,0 +1,179 @@
+#include "configuration.hpp"
+
+#include <docopt/docopt.h>
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <system_error>
+
+namespace tictactoe {
+
+namespace {
+
+constexpr auto USAGE =
+    R"(Tic-tac-toe.
+
+    Usage:
+      game [options]
+
+    Options:
+      -h --help          Show this screen.
+      --size=<n>         Number of fields along each side [default: 3].
+      --rows=<n>         Number of rows, overrides --size.
+      --cols=<n>         Number of columns, overrides --size.
+      --win=<k>          Stones in a row needed to win; defaults to the
+                         shorter side of the board.
+      --ai=<side>        Let the computer play as 'cross' or 'circle'.
+      --ai-time=<ms>     Computer thinking time per move [default: 1000].
+      --ai-engine=<e>    Search used by the computer, 'negamax' or 'mcts'
+                         [default: negamax].
+      --playouts=<n>     MCTS playouts per move [default: 20000].
+      --ai-threads=<n>   MCTS playout threads; defaults to all cores.
+      --render=<mode>    Redraw 'continuous'ly or only 'on-demand' when
+                         something changed [default: continuous].
+      --connect=<addr>   Play on the game server at host:port.
+      --join=<id>        Join this game on the server instead of creating
+                         one.
+      --metrics=<file>   Write timing metrics in Prometheus text format to
+                         this file every few seconds and on exit.
+      --record-input=<file>  Write the clicks, window sizes and moves to this
+                         file, to be replayed by ui_replay.
+)";
+
+outcome::result<int> ParsePositiveInt(const docopt::value& value) {
+  try {
+    const auto parsed = value.asLong();
+    if (parsed <= 0 or parsed > std::numeric_limits<int>::max()) {
+      return std::errc::argument_out_of_domain;
+    }
+    return static_cast<int>(parsed);
+  } catch (const std::exception&) {
+    return std::errc::invalid_argument;
+  }
+}
+
+outcome::result<std::optional<Player>> ParsePlayer(const docopt::value& value) {
+  if (!value) {
+    return std::optional<Player>{};
+  }
+  if (value.asString() == "cross") {
+    return std::optional<Player>{Player::CrossPlayer};
+  }
+  if (value.asString() == "circle") {
+    return std::optional<Player>{Player::CirclePlayer};
+  }
+  return std::errc::invalid_argument;
+}
+
+outcome::result<RenderMode> ParseRenderMode(const docopt::value& value) {
+  if (value.asString() == "continuous") {
+    return RenderMode::Continuous;
+  }
+  if (value.asString() == "on-demand") {
+    return RenderMode::OnDemand;
+  }
+  return std::errc::invalid_argument;
+}
+
+outcome::result<std::optional<ServerAddress>> ParseServerAddress(
+    const docopt::value& value) {
+  if (!value) {
+    return std::optional<ServerAddress>{};
+  }
+  const auto& text = value.asString();
+  const auto colon = text.rfind(':');
+  if (colon == std::string::npos or colon == 0) {
+    return std::errc::invalid_argument;
+  }
+  ServerAddress address;
+  address.host = text.substr(0, colon);
+  try {
+    const auto port_text = text.substr(colon + 1);
+    std::size_t used = 0;
+    const auto port = std::stol(port_text, &used);
+    if (used != port_text.size()) {
+      return std::errc::invalid_argument;
+    }
+    if (port <= 0 or port > std::numeric_limits<std::uint16_t>::max()) {
+      return std::errc::argument_out_of_domain;
+    }
+    address.port = static_cast<std::uint16_t>(port);
+  } catch (const std::exception&) {
+    return std::errc::invalid_argument;
+  }
+  return std::optional<ServerAddress>{address};
+}
+
+outcome::result<AiEngine> ParseAiEngine(const docopt::value& value) {
+  if (value.asString() == "negamax") {
+    return AiEngine::Negamax;
+  }
+  if (value.asString() == "mcts") {
+    return AiEngine::Mcts;
+  }
+  return std::errc::invalid_argument;
+}
+
+}  // namespace
+
+outcome::result<fs::path> MakeAssetDir(const fs::path& start_dir,
+                                       const fs::path& work_dir) {
+  fs::path assets = start_dir.is_absolute() ? start_dir : work_dir / start_dir;
+
+  assets.remove_filename();
+  assets /= "../assets";
+
+  return assets;
+}
+
+outcome::result<Configuration> MakeConfiguration(
+    const std::vector<std::string>& commandline_args,
+    const fs::path& work_dir) {
+  const auto options = docopt::docopt(
+      USAGE, {std::next(commandline_args.begin()), commandline_args.end()},
+      true);
+
+  Configuration config;
+  config.asset_dir =
+      OUTCOME_TRYX(MakeAssetDir(fs::path{commandline_args[0]}, work_dir));
+  const int size = OUTCOME_TRYX(ParsePositiveInt(options.at("--size")));
+  config.rules.rows = options.at("--rows")
+                          ? OUTCOME_TRYX(ParsePositiveInt(options.at("--rows")))
+                          : size;
+  config.rules.cols = options.at("--cols")
+                          ? OUTCOME_TRYX(ParsePositiveInt(options.at("--cols")))
+                          : size;
+  config.rules.win_length =
+      options.at("--win") ? OUTCOME_TRYX(ParsePositiveInt(options.at("--win")))
+                          : std::min(config.rules.rows, config.rules.cols);
+  config.ai_player = OUTCOME_TRYX(ParsePlayer(options.at("--ai")));
+  config.ai_time_budget = std::chrono::milliseconds{
+      OUTCOME_TRYX(ParsePositiveInt(options.at("--ai-time")))};
+  config.ai_engine = OUTCOME_TRYX(ParseAiEngine(options.at("--ai-engine")));
+  config.ai_playouts = static_cast<std::uint64_t>(
+      OUTCOME_TRYX(ParsePositiveInt(options.at("--playouts"))));
+  config.ai_threads =
+      options.at("--ai-threads")
+          ? static_cast<unsigned>(
+                OUTCOME_TRYX(ParsePositiveInt(options.at("--ai-threads"))))
+          : 0U;
+  config.render_mode = OUTCOME_TRYX(ParseRenderMode(options.at("--render")));
+  config.server = OUTCOME_TRYX(ParseServerAddress(options.at("--connect")));
+  if (options.at("--join")) {
+    config.join_game = static_cast<std::uint64_t>(
+        OUTCOME_TRYX(ParsePositiveInt(options.at("--join"))));
+  }
+  if (options.at("--metrics")) {
+    config.metrics_file = fs::path{options.at("--metrics").asString()};
+  }
+  if (options.at("--record-input")) {
+    config.input_record_file =
+        fs::path{options.at("--record-input").asString()};
+  }
+  return config;
+}
+
+}  // namespace tictactoe
@@ -0,0 +1,65 @@
+#ifndef TICTACTOE_CONFIGURATION_H_
+#define TICTACTOE_CONFIGURATION_H_
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <outcome.hpp>
+#include <string>
+#include <vector>
+
+#include "board.hpp"
+
+namespace tictactoe {
+
+namespace fs = std::filesystem;
+
+enum class RenderMode {
+  // Redraw every frame at the frame rate limit.
+  Continuous,
+  // Sleep until an event arrives and redraw only when something changed.
+  OnDemand,
+};
+
+enum class AiEngine {
+  // Iterative deepening alpha-beta; exact on small boards.
+  Negamax,
+  // Monte Carlo tree search; scales to large boards.
+  Mcts,
+};
+
+// Game server to play on instead of the local engine.
+struct ServerAddress {
+  std::string host;
+  std::uint16_t port = 0;
+};
+
+struct Configuration {
+  fs::path asset_dir;
+  GameRules rules;
+  std::optional<Player> ai_player;
+  std::chrono::milliseconds ai_time_budget{1000};
+  AiEngine ai_engine = AiEngine::Negamax;
+  std::uint64_t ai_playouts = 20'000;
+  // 0 uses all hardware threads.
+  unsigned ai_threads = 0;
+  RenderMode render_mode = RenderMode::Continuous;
+  std::optional<ServerAddress> server;
+  // Game to join on the server; a new one is created otherwise.
+  std::optional<std::uint64_t> join_game;
+  // Where to write the timing metrics in Prometheus text format.
+  std::optional<fs::path> metrics_file;
+  // Where to record the clicks and resizes as an input script.
+  std::optional<fs::path> input_record_file;
+};
+
+outcome::result<fs::path> MakeAssetDir(const fs::path& start_dir,
+                                       const fs::path& work_dir);
+
+outcome::result<Configuration> MakeConfiguration(
+    const std::vector<std::string>& commandline_args, const fs::path& work_dir);
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_CONFIGURATION_H_
@@ -0,0 +1,313 @@
+#include "engine.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <initializer_list>
+#include <limits>
+#include <system_error>
+
+namespace tictactoe {
+
+namespace {
+
+std::optional<Player> owner_of(FieldState state) {
+  switch (state) {
+    case FieldState::Circle:
+      return Player::CirclePlayer;
+    case FieldState::Cross:
+      return Player::CrossPlayer;
+    default:
+      return std::nullopt;
+  }
+}
+
+// Directions in which a winning run can extend: along a row, along a column,
+// along the diagonal and along the antidiagonal.
+constexpr std::array<std::array<int, 2>, 4> kDirections = {
+    {{0, 1}, {1, 0}, {1, 1}, {1, -1}}};
+
+}  // namespace
+
+Engine::Engine(const GameRules& rules)
+    : fields_(static_cast<std::size_t>(rules.num_cells())),
+      rules_{rules},
+      counters_{LineCounters{rules}, LineCounters{rules}} {
+  // A game never has more moves than cells, so making them never allocates.
+  // Only undo() fills undone_, so it grows on demand instead.
+  moves_.reserve(fields_.size());
+}
+
+int Engine::fields_to_edge(int row, int col, int drow, int dcol) const {
+  int steps = std::numeric_limits<int>::max();
+  if (drow != 0) {
+    steps = std::min(steps, drow > 0 ? rules_.rows - 1 - row : row);
+  }
+  if (dcol != 0) {
+    steps = std::min(steps, dcol > 0 ? rules_.cols - 1 - col : col);
+  }
+  return steps;
+}
+
+PackedBoard::Line Engine::line_from(int row, int col, int drow, int dcol,
+                                    int length) const {
+  const int fields = std::min(length, 1 + fields_to_edge(row, col, drow, dcol));
+  return fields_.line(pos2idx(row, col, rules_.cols), drow * rules_.cols + dcol,
+                      static_cast<std::size_t>(fields));
+}
+
+EngineMemory Engine::memory_usage() const {
+  const auto vector_bytes = [](const std::vector<int>& v) {
+    return v.capacity() * sizeof(int);
+  };
+  EngineMemory memory;
+  memory.board_bytes = fields_.bytes();
+  memory.unpacked_board_bytes = fields_.size() * sizeof(int);
+  memory.total_bytes = sizeof(Engine) + memory.board_bytes +
+                       vector_bytes(moves_) + vector_bytes(undone_);
+  for (const auto& c : counters_) {
+    memory.total_bytes += vector_bytes(c.rows) + vector_bytes(c.cols);
+  }
+  return memory;
+}
+
+Position Engine::position_of(int cell) const {
+  return Position::create_position_for_engine(cell / rules_.cols,
+                                              cell % rules_.cols, *this)
+      .value();
+}
+
+void Engine::update_line_counters(const Position& pos, FieldState state,
+                                  int delta) {
+  const auto owner = owner_of(state);
+  if (!owner or !rules_.is_full_line()) {
+    return;
+  }
+
+  auto& c = counters_for(*owner);
+  c.rows[static_cast<std::size_t>(pos.row())] += delta;
+  c.cols[static_cast<std::size_t>(pos.col())] += delta;
+  if (pos.row() == pos.col()) {
+    c.diagonal += delta;
+  }
+  if (pos.row() + pos.col() == rules_.cols - 1) {
+    c.antidiagonal += delta;
+  }
+}
+
+// Number of consecutive stones of the same colour as the one at pos along
+// the given direction, counting pos itself. Never looks further than
+// win_length - 1 fields either way.
+int Engine::run_length_through(const Position& pos, int drow, int dcol) const {
+  const auto state = get_field_state_at(pos);
+  int run = 1;
+  for (int sign : {-1, 1}) {
+    const auto line = line_from(pos.row(), pos.col(), sign * drow, sign * dcol,
+                                rules_.win_length);
+    // the line starts at pos itself
+    for (auto it = std::next(line.begin());
+         it != line.end() and *it == state; ++it) {
+      ++run;
+    }
+  }
+  return run;
+}
+
+// Only lines passing through the last placed stone can have been completed by
+// it. With full-line rules the (at most four) counters decide that in O(1);
+// otherwise the four directions are scanned, at most win_length fields each.
+std::optional<Player> Engine::maybe_get_winner_through(
+    const Position& pos) const {
+  const auto owner = owner_of(get_field_state_at(pos));
+  if (!owner) {
+    return std::nullopt;
+  }
+
+  if (rules_.is_full_line()) {
+    const auto& c = counters_for(*owner);
+    const int n = rules_.win_length;
+    const bool complete = c.rows[static_cast<std::size_t>(pos.row())] == n or
+                          c.cols[static_cast<std::size_t>(pos.col())] == n or
+                          c.diagonal == n or c.antidiagonal == n;
+    return complete ? owner : std::nullopt;
+  }
+
+  for (const auto& [drow, dcol] : kDirections) {
+    if (run_length_through(pos, drow, dcol) >= rules_.win_length) {
+      return owner;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<Player> Engine::maybe_winner_on_line(int row, int col, int drow,
+                                                   int dcol) const {
+  FieldState run_state = FieldState::Empty;
+  int run = 0;
+  for (const auto state : line_from(row, col, drow, dcol,
+                                    std::numeric_limits<int>::max())) {
+    run = state == run_state ? run + 1 : 1;
+    run_state = state;
+    if (run_state != FieldState::Empty and run >= rules_.win_length) {
+      return owner_of(run_state);
+    }
+  }
+  return std::nullopt;
+}
+
+outcome::result<Engine> Engine::create_engine(int board_size) {
+  return create_engine(GameRules::square(board_size));
+}
+
+outcome::result<Engine> Engine::create_engine(const GameRules& rules) {
+  if (rules.rows < 1 or rules.cols < 1 or rules.win_length <= 1) {
+    return std::errc::argument_out_of_domain;
+  }
+  if (rules.win_length > rules.rows and rules.win_length > rules.cols) {
+    return std::errc::argument_out_of_domain;
+  }
+  // GameRules::num_cells() and the cell indices are ints
+  if (rules.rows > std::numeric_limits<int>::max() / rules.cols) {
+    return std::errc::argument_out_of_domain;
+  }
+  return Engine(rules);
+}
+
+std::optional<Player> Engine::maybe_winner_for_row(int row_id) const {
+  if (row_id < 0 or row_id >= rules_.rows) {
+    return std::nullopt;
+  }
+  return maybe_winner_on_line(row_id, 0, 0, 1);
+}
+
+std::optional<Player> Engine::maybe_winner_for_column(int col_id) const {
+  if (col_id < 0 or col_id >= rules_.cols) {
+    return std::nullopt;
+  }
+  return maybe_winner_on_line(0, col_id, 1, 0);
+}
+
+std::optional<Player> Engine::maybe_get_winner_for_diagonal() const {
+  return maybe_winner_on_line(0, 0, 1, 1);
+}
+
+std::optional<Player> Engine::maybe_get_winner_for_antidiagonal() const {
+  return maybe_winner_on_line(0, rules_.cols - 1, 1, -1);
+}
+
+std::optional<Player> Engine::maybe_get_winner() const {
+  for (int i = 0; i < rules_.rows; ++i) {
+    if (auto player_opt = maybe_winner_for_row(i)) {
+      return player_opt;
+    }
+  }
+
+  for (int i = 0; i < rules_.cols; ++i) {
+    if (auto player_opt = maybe_winner_for_column(i)) {
+      return player_opt;
+    }
+  }
+
+  // every diagonal starts either in the top row or in the first (for
+  // antidiagonals: last) column
+  for (int col = 0; col < rules_.cols; ++col) {
+    if (auto player_opt = maybe_winner_on_line(0, col, 1, 1)) {
+      return player_opt;
+    }
+    if (auto player_opt = maybe_winner_on_line(0, col, 1, -1)) {
+      return player_opt;
+    }
+  }
+  for (int row = 1; row < rules_.rows; ++row) {
+    if (auto player_opt = maybe_winner_on_line(row, 0, 1, 1)) {
+      return player_opt;
+    }
+    if (auto player_opt = maybe_winner_on_line(row, rules_.cols - 1, 1, -1)) {
+      return player_opt;
+    }
+  }
+
+  return std::nullopt;
+}
+
+Player Engine::next_player() const {
+  switch (active_player_) {
+    case Player::CrossPlayer:
+      return Player::CirclePlayer;
+    case Player::CirclePlayer:
+    default:
+      return Player::CrossPlayer;
+  }
+}
+
+outcome::result<void> Engine::update_field_state_at(const Position& pos,
+                                                    FieldState state) {
+  if (state == FieldState::Empty) {
+    return std::errc::argument_out_of_domain;
+  }
+  const auto cell = pos2idx(pos.row(), pos.col(), rules_.cols);
+  update_line_counters(pos, fields_.at(cell), -1);
+  fields_.set(cell, state);
+  update_line_counters(pos, state, +1);
+  return outcome::success();
+}
+
+outcome::result<void> Engine::handle_field_selected(const Position& pos) {
+  if (winner_) {
+    return outcome::success();
+  }
+
+  FieldState state = get_field_state_at(pos);
+  if (state != FieldState::Empty) {
+    return outcome::failure(std::errc::invalid_argument);
+  }
+
+  make_move(pos);
+  undone_.clear();
+  return outcome::success();
+}
+
+void Engine::make_move(const Position& pos) {
+  const auto cell = pos2idx(pos.row(), pos.col(), rules_.cols);
+  const auto stone = active_player_ == Player::CrossPlayer ? FieldState::Cross
+                                                          : FieldState::Circle;
+  fields_.set(cell, stone);
+  update_line_counters(pos, stone, +1);
+  moves_.push_back(static_cast<int>(cell));
+
+  active_player_ = next_player();
+  winner_ = maybe_get_winner_through(pos);
+}
+
+void Engine::unmake_move() {
+  assert(!moves_.empty());
+  const auto pos = position_of(moves_.back());
+  moves_.pop_back();
+
+  const auto cell = pos2idx(pos.row(), pos.col(), rules_.cols);
+  update_line_counters(pos, fields_[cell], -1);
+  fields_.set(cell, FieldState::Empty);
+
+  // no move is accepted after a win, so the position before had no winner
+  active_player_ = next_player();
+  winner_ = std::nullopt;
+}
+
+outcome::result<void> Engine::undo() {
+  if (moves_.empty()) {
+    return std::errc::operation_not_permitted;
+  }
+  undone_.push_back(moves_.back());
+  unmake_move();
+  return outcome::success();
+}
+
+outcome::result<void> Engine::redo() {
+  if (undone_.empty()) {
+    return std::errc::operation_not_permitted;
+  }
+  make_move(position_of(undone_.back()));
+  undone_.pop_back();
+  return outcome::success();
+}
+
+}  // namespace tictactoe
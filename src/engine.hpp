@@ -0,0 +1,136 @@
+#ifndef TICTACTOE_ENGINE_H_
+#define TICTACTOE_ENGINE_H_
+
+#include <array>
+#include <cassert>
+#include <optional>
+#include <outcome.hpp>
+#include <vector>
+
+#include "board.hpp"
+#include "packed_board.hpp"
+
+namespace tictactoe {
+
+// Heap and object bytes an Engine takes, see Engine::memory_usage().
+struct EngineMemory {
+  std::size_t board_bytes = 0;
+  // What the board took as one FieldState with int underlying type per field.
+  std::size_t unpacked_board_bytes = 0;
+  std::size_t total_bytes = 0;
+};
+
+// Rules of the game for a board whose size is chosen at runtime. Has no
+// dependency on any rendering code, so it can be driven headlessly.
+class Engine {
+  using BoardData = PackedBoard;
+
+  // Number of stones a single player has on each line of the board. Only
+  // maintained for full-line rules, where a player wins as soon as any of
+  // their counters reaches the board size.
+  struct LineCounters {
+    std::vector<int> rows;
+    std::vector<int> cols;
+    int diagonal = 0;
+    int antidiagonal = 0;
+
+    explicit LineCounters(const GameRules& rules)
+        : rows(static_cast<std::size_t>(rules.is_full_line() ? rules.rows : 0),
+               0),
+          cols(static_cast<std::size_t>(rules.is_full_line() ? rules.cols : 0),
+               0) {}
+  };
+
+  BoardData fields_;
+  GameRules rules_;
+  Player active_player_ = Player::CrossPlayer;
+  std::optional<Player> winner_ = std::nullopt;
+  std::array<LineCounters, 2> counters_;
+  // Cells (pos2idx) in the order they were played, and the moves taken back
+  // by undo() that redo() can replay.
+  std::vector<int> moves_;
+  std::vector<int> undone_;
+
+  explicit Engine(const GameRules& rules);
+
+  LineCounters& counters_for(Player p) {
+    return counters_[p == Player::CirclePlayer ? 0 : 1];
+  }
+  const LineCounters& counters_for(Player p) const {
+    return counters_[p == Player::CirclePlayer ? 0 : 1];
+  }
+
+  // Fields after (row, col) in direction (drow, dcol) before the edge.
+  int fields_to_edge(int row, int col, int drow, int dcol) const;
+  // The fields from (row, col) on in direction (drow, dcol), at most length.
+  PackedBoard::Line line_from(int row, int col, int drow, int dcol,
+                              int length) const;
+
+  void make_move(const Position& pos);
+  void update_line_counters(const Position& pos, FieldState state, int delta);
+  std::optional<Player> maybe_get_winner_through(const Position& pos) const;
+  int run_length_through(const Position& pos, int drow, int dcol) const;
+  std::optional<Player> maybe_winner_on_line(int row, int col, int drow,
+                                             int dcol) const;
+
+ public:
+  // Classic rules: board_size x board_size, a full line wins.
+  static outcome::result<Engine> create_engine(int board_size);
+  static outcome::result<Engine> create_engine(const GameRules& rules);
+
+  // Each of these reports a run of win_length() stones anywhere on the line.
+  std::optional<Player> maybe_winner_for_row(int row_id) const;
+  std::optional<Player> maybe_winner_for_column(int col_id) const;
+  std::optional<Player> maybe_get_winner_for_diagonal() const;
+  std::optional<Player> maybe_get_winner_for_antidiagonal() const;
+
+  // Scans the whole board. handle_field_selected() only inspects the lines
+  // through the last move; this is kept as the reference implementation.
+  std::optional<Player> maybe_get_winner() const;
+
+  Player get_active_player() const { return active_player_; }
+  const GameRules& rules() const { return rules_; }
+  // Side of a square board, as with create_engine(board_size); other boards
+  // only have rows() and cols().
+  int board_size() const {
+    assert(rules_.rows == rules_.cols);
+    return rules_.rows;
+  }
+  int rows() const { return rules_.rows; }
+  int cols() const { return rules_.cols; }
+  int win_length() const { return rules_.win_length; }
+  std::optional<Player> maybe_winner() const { return winner_; }
+
+  // The position of a pos2idx cell index on this board.
+  Position position_of(int cell) const;
+
+  FieldState get_field_state_at(const Position& pos) const {
+    return fields_.at(pos2idx(pos.row(), pos.col(), rules_.cols));
+  }
+
+  EngineMemory memory_usage() const;
+
+  Player next_player() const;
+
+  outcome::result<void> update_field_state_at(const Position& pos,
+                                              FieldState state);
+  outcome::result<void> handle_field_selected(const Position& pos);
+
+  // Takes back the last move in O(1), restoring the player to move, the
+  // winner and the line counters. Searches pair it with
+  // handle_field_selected() instead of copying the engine for every move.
+  // There has to be a move to take back.
+  void unmake_move();
+
+  const std::vector<int>& move_history() const { return moves_; }
+  bool can_undo() const { return !moves_.empty(); }
+  bool can_redo() const { return !undone_.empty(); }
+  // Like unmake_move(), but remembers the move for redo(). Selecting a new
+  // field forgets all undone moves.
+  outcome::result<void> undo();
+  outcome::result<void> redo();
+};
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_ENGINE_H_
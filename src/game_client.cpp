@@ -0,0 +1,158 @@
+#include "game_client.hpp"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <memory>
+#include <system_error>
+#include <utility>
+
+namespace tictactoe {
+
+namespace {
+
+#if defined(MSG_NOSIGNAL)
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+std::error_code last_error() { return {errno, std::generic_category()}; }
+
+}  // namespace
+
+outcome::result<GameClient> GameClient::connect(const std::string& host,
+                                                std::uint16_t port) {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* found = nullptr;
+  if (::getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints,
+                    &found) != 0) {
+    return std::errc::host_unreachable;
+  }
+  const std::unique_ptr<addrinfo, decltype(&::freeaddrinfo)> addresses{
+      found, &::freeaddrinfo};
+
+  std::error_code error = std::make_error_code(std::errc::host_unreachable);
+  for (const auto* a = addresses.get(); a != nullptr; a = a->ai_next) {
+    const int fd = ::socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+    if (fd < 0) {
+      error = last_error();
+      continue;
+    }
+    if (::connect(fd, a->ai_addr, a->ai_addrlen) != 0) {
+      error = last_error();
+      ::close(fd);
+      continue;
+    }
+    const int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return GameClient{fd};
+  }
+  return error;
+}
+
+GameClient::GameClient(GameClient&& other) noexcept
+    : fd_{std::exchange(other.fd_, -1)}, in_{std::move(other.in_)} {}
+
+GameClient::~GameClient() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+}
+
+outcome::result<void> GameClient::send(const protocol::Request& request) {
+  const auto line = protocol::format(request);
+  std::size_t sent = 0;
+  while (sent < line.size()) {
+    const auto n =
+        ::send(fd_, line.data() + sent, line.size() - sent, kSendFlags);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return last_error();
+    }
+    sent += static_cast<std::size_t>(n);
+  }
+  return outcome::success();
+}
+
+outcome::result<void> GameClient::receive(int timeout_ms) {
+  pollfd p{fd_, POLLIN, 0};
+  const int ready = ::poll(&p, 1, timeout_ms);
+  if (ready < 0 and errno != EINTR) {
+    return last_error();
+  }
+  if (ready <= 0) {
+    return outcome::success();
+  }
+
+  char buffer[4096];
+  const auto n = ::recv(fd_, buffer, sizeof(buffer), 0);
+  if (n == 0) {
+    return std::errc::connection_reset;
+  }
+  if (n < 0) {
+    if (errno == EINTR) {
+      return outcome::success();
+    }
+    return last_error();
+  }
+  in_.append(buffer, static_cast<std::size_t>(n));
+  return outcome::success();
+}
+
+outcome::result<void> GameClient::take_lines(
+    std::vector<protocol::Reply>& replies) {
+  std::size_t start = 0;
+  for (auto end = in_.find('\n'); end != std::string::npos;
+       end = in_.find('\n', start)) {
+    auto reply = protocol::parse_reply(
+        std::string_view{in_}.substr(start, end - start));
+    start = end + 1;
+    if (!reply) {
+      in_.erase(0, start);
+      return reply.error();
+    }
+    replies.push_back(std::move(reply).value());
+  }
+  in_.erase(0, start);
+  return outcome::success();
+}
+
+outcome::result<std::vector<protocol::Reply>> GameClient::poll() {
+  OUTCOME_TRYV(receive(0));
+  std::vector<protocol::Reply> replies;
+  OUTCOME_TRYV(take_lines(replies));
+  return replies;
+}
+
+outcome::result<protocol::Reply> GameClient::wait(
+    std::chrono::milliseconds timeout) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (true) {
+    // lines beyond the first are kept for the next call
+    const auto newline = in_.find('\n');
+    if (newline != std::string::npos) {
+      auto reply =
+          protocol::parse_reply(std::string_view{in_}.substr(0, newline));
+      in_.erase(0, newline + 1);
+      return reply;
+    }
+    const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now());
+    if (left.count() <= 0) {
+      return std::errc::timed_out;
+    }
+    OUTCOME_TRYV(receive(static_cast<int>(left.count())));
+  }
+}
+
+}  // namespace tictactoe
@@ -0,0 +1,48 @@
+#ifndef TICTACTOE_GAME_CLIENT_H_
+#define TICTACTOE_GAME_CLIENT_H_
+
+#include <chrono>
+#include <cstdint>
+#include <outcome.hpp>
+#include <string>
+#include <vector>
+
+#include "game_protocol.hpp"
+
+namespace tictactoe {
+
+// Connection to a GameServer. Requests are sent as they are made; replies
+// are collected without blocking, so a render loop can poll them every
+// frame.
+class GameClient {
+ public:
+  static outcome::result<GameClient> connect(const std::string& host,
+                                             std::uint16_t port);
+
+  GameClient(GameClient&& other) noexcept;
+  GameClient& operator=(GameClient&&) = delete;
+  GameClient(const GameClient&) = delete;
+  GameClient& operator=(const GameClient&) = delete;
+  ~GameClient();
+
+  outcome::result<void> send(const protocol::Request& request);
+
+  // Replies that have arrived completely; empty when there are none yet.
+  outcome::result<std::vector<protocol::Reply>> poll();
+
+  // Waits for the next reply.
+  outcome::result<protocol::Reply> wait(std::chrono::milliseconds timeout);
+
+ private:
+  explicit GameClient(int fd) : fd_{fd} {}
+
+  outcome::result<void> receive(int timeout_ms);
+  outcome::result<void> take_lines(std::vector<protocol::Reply>& replies);
+
+  int fd_ = -1;
+  std::string in_;
+};
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_GAME_CLIENT_H_
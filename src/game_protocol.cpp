@@ -0,0 +1,226 @@
+#include "game_protocol.hpp"
+
+#include <charconv>
+#include <system_error>
+#include <type_traits>
+
+namespace tictactoe::protocol {
+
+namespace {
+
+std::string_view seat_name(Seat seat) {
+  switch (seat) {
+    case Seat::Cross:
+      return "cross";
+    case Seat::Circle:
+      return "circle";
+    case Seat::Both:
+      return "both";
+  }
+  return "both";
+}
+
+// Splits a line into its words, consuming it front to back.
+class Words {
+ public:
+  explicit Words(std::string_view line) : rest_{line} {
+    while (!rest_.empty() and (rest_.back() == '\n' or rest_.back() == '\r')) {
+      rest_.remove_suffix(1);
+    }
+  }
+
+  bool done() const { return rest_.empty(); }
+
+  std::string_view next() {
+    const auto end = rest_.find(' ');
+    const auto word = rest_.substr(0, end);
+    rest_.remove_prefix(end == std::string_view::npos ? rest_.size()
+                                                      : end + 1);
+    return word;
+  }
+
+  // Everything not consumed yet.
+  std::string_view rest() {
+    const auto r = rest_;
+    rest_ = {};
+    return r;
+  }
+
+  template <typename T>
+  outcome::result<T> number() {
+    const auto word = next();
+    T value{};
+    const auto [end, ec] =
+        std::from_chars(word.data(), word.data() + word.size(), value);
+    if (word.empty() or ec != std::errc{} or end != word.data() + word.size()) {
+      return std::errc::invalid_argument;
+    }
+    return value;
+  }
+
+  outcome::result<int> coordinate() {
+    const int value = OUTCOME_TRYX(number<int>());
+    if (value < 0 or value >= kMaxBoardSide) {
+      return std::errc::argument_out_of_domain;
+    }
+    return value;
+  }
+
+ private:
+  std::string_view rest_;
+};
+
+std::string rules_words(const GameRules& rules) {
+  return std::to_string(rules.rows) + ' ' + std::to_string(rules.cols) + ' ' +
+         std::to_string(rules.win_length);
+}
+
+outcome::result<GameRules> read_rules(Words& words) {
+  GameRules rules;
+  rules.rows = OUTCOME_TRYX(words.number<int>());
+  rules.cols = OUTCOME_TRYX(words.number<int>());
+  rules.win_length = OUTCOME_TRYX(words.number<int>());
+  for (const int n : {rules.rows, rules.cols, rules.win_length}) {
+    if (n < 1 or n > kMaxBoardSide) {
+      return std::errc::argument_out_of_domain;
+    }
+  }
+  return rules;
+}
+
+template <typename T>
+outcome::result<T> finish(Words& words, T message) {
+  if (!words.done()) {
+    return std::errc::invalid_argument;
+  }
+  return message;
+}
+
+}  // namespace
+
+std::string format(const Request& request) {
+  return std::visit(
+             [](const auto& r) -> std::string {
+               using T = std::decay_t<decltype(r)>;
+               if constexpr (std::is_same_v<T, NewGame>) {
+                 return "NEW " + rules_words(r.rules);
+               } else if constexpr (std::is_same_v<T, JoinGame>) {
+                 return "JOIN " + std::to_string(r.game);
+               } else if constexpr (std::is_same_v<T, MakeMove>) {
+                 return "MOVE " + std::to_string(r.game) + ' ' +
+                        std::to_string(r.row) + ' ' + std::to_string(r.col);
+               } else if constexpr (std::is_same_v<T, LeaveGame>) {
+                 return "LEAVE " + std::to_string(r.game);
+               } else {
+                 return "STATS";
+               }
+             },
+             request) +
+         '\n';
+}
+
+std::string format(const Reply& reply) {
+  return std::visit(
+             [](const auto& r) -> std::string {
+               using T = std::decay_t<decltype(r)>;
+               if constexpr (std::is_same_v<T, GameJoined>) {
+                 return "GAME " + std::to_string(r.game) + ' ' +
+                        std::string{seat_name(r.seat)} + ' ' +
+                        rules_words(r.rules);
+               } else if constexpr (std::is_same_v<T, MoveMade>) {
+                 return "MOVED " + std::to_string(r.game) + ' ' +
+                        std::to_string(r.row) + ' ' + std::to_string(r.col);
+               } else if constexpr (std::is_same_v<T, GameLeft>) {
+                 return "LEFT " + std::to_string(r.game);
+               } else if constexpr (std::is_same_v<T, StatsReport>) {
+                 std::string line = "STATS";
+                 for (const auto& [name, value] : r.values) {
+                   line += ' ' + name + '=' + std::to_string(value);
+                 }
+                 return line;
+               } else {
+                 return "ERR " + r.reason;
+               }
+             },
+             reply) +
+         '\n';
+}
+
+outcome::result<Request> parse_request(std::string_view line) {
+  Words words{line};
+  const auto verb = words.next();
+  if (verb == "NEW") {
+    return finish<Request>(words, NewGame{OUTCOME_TRYX(read_rules(words))});
+  }
+  if (verb == "JOIN") {
+    return finish<Request>(
+        words, JoinGame{OUTCOME_TRYX(words.number<std::uint64_t>())});
+  }
+  if (verb == "MOVE") {
+    MakeMove move;
+    move.game = OUTCOME_TRYX(words.number<std::uint64_t>());
+    move.row = OUTCOME_TRYX(words.coordinate());
+    move.col = OUTCOME_TRYX(words.coordinate());
+    return finish<Request>(words, move);
+  }
+  if (verb == "LEAVE") {
+    return finish<Request>(
+        words, LeaveGame{OUTCOME_TRYX(words.number<std::uint64_t>())});
+  }
+  if (verb == "STATS") {
+    return finish<Request>(words, QueryStats{});
+  }
+  return std::errc::invalid_argument;
+}
+
+outcome::result<Reply> parse_reply(std::string_view line) {
+  Words words{line};
+  const auto verb = words.next();
+  if (verb == "GAME") {
+    GameJoined joined;
+    joined.game = OUTCOME_TRYX(words.number<std::uint64_t>());
+    const auto seat = words.next();
+    if (seat == "cross") {
+      joined.seat = Seat::Cross;
+    } else if (seat == "circle") {
+      joined.seat = Seat::Circle;
+    } else if (seat == "both") {
+      joined.seat = Seat::Both;
+    } else {
+      return std::errc::invalid_argument;
+    }
+    joined.rules = OUTCOME_TRYX(read_rules(words));
+    return finish<Reply>(words, joined);
+  }
+  if (verb == "MOVED") {
+    MoveMade move;
+    move.game = OUTCOME_TRYX(words.number<std::uint64_t>());
+    move.row = OUTCOME_TRYX(words.coordinate());
+    move.col = OUTCOME_TRYX(words.coordinate());
+    return finish<Reply>(words, move);
+  }
+  if (verb == "LEFT") {
+    return finish<Reply>(
+        words, GameLeft{OUTCOME_TRYX(words.number<std::uint64_t>())});
+  }
+  if (verb == "STATS") {
+    StatsReport report;
+    while (!words.done()) {
+      const auto pair = words.next();
+      const auto eq = pair.find('=');
+      if (eq == std::string_view::npos) {
+        return std::errc::invalid_argument;
+      }
+      Words value{pair.substr(eq + 1)};
+      report.values.emplace_back(std::string{pair.substr(0, eq)},
+                                 OUTCOME_TRYX(value.number<std::uint64_t>()));
+    }
+    return report;
+  }
+  if (verb == "ERR") {
+    return Reply{Error{std::string{words.rest()}}};
+  }
+  return std::errc::invalid_argument;
+}
+
+}  // namespace tictactoe::protocol
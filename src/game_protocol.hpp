@@ -0,0 +1,95 @@
+#ifndef TICTACTOE_GAME_PROTOCOL_H_
+#define TICTACTOE_GAME_PROTOCOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <outcome.hpp>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "board.hpp"
+
+namespace tictactoe {
+
+// Sides of a networked game a connection plays. The creator of a game plays
+// both until an opponent joins.
+enum class Seat { Cross, Circle, Both };
+
+// Text protocol spoken between the game server and its clients: one message
+// per '\n'-terminated line, words separated by single spaces.
+//
+//   client -> server          server -> client
+//   NEW <rows> <cols> <win>   GAME <id> <cross|circle|both> <rows> <cols> <win>
+//   JOIN <id>                 MOVED <id> <row> <col>
+//   MOVE <id> <row> <col>     LEFT <id>
+//   LEAVE <id>                STATS <name>=<value> ...
+//   STATS                     ERR <reason>
+//
+// GAME answers NEW and JOIN, and tells the creator its seat changed when an
+// opponent joins; a joining client then gets a MOVED for every move so far.
+// MOVED goes to both players. LEFT answers LEAVE and tells the opponent the
+// game has ended.
+namespace protocol {
+
+// Longest line either side accepts, including the newline.
+constexpr std::size_t kMaxLineLength = 512;
+// Largest board side a client may ask for.
+constexpr int kMaxBoardSide = 255;
+
+struct NewGame {
+  GameRules rules;
+};
+struct JoinGame {
+  std::uint64_t game = 0;
+};
+struct MakeMove {
+  std::uint64_t game = 0;
+  int row = 0;
+  int col = 0;
+};
+struct LeaveGame {
+  std::uint64_t game = 0;
+};
+struct QueryStats {};
+
+using Request =
+    std::variant<NewGame, JoinGame, MakeMove, LeaveGame, QueryStats>;
+
+struct GameJoined {
+  std::uint64_t game = 0;
+  Seat seat = Seat::Both;
+  GameRules rules;
+};
+struct MoveMade {
+  std::uint64_t game = 0;
+  int row = 0;
+  int col = 0;
+};
+struct GameLeft {
+  std::uint64_t game = 0;
+};
+struct StatsReport {
+  std::vector<std::pair<std::string, std::uint64_t>> values;
+};
+struct Error {
+  std::string reason;
+};
+
+using Reply = std::variant<GameJoined, MoveMade, GameLeft, StatsReport, Error>;
+
+// Both return the line including its newline.
+std::string format(const Request& request);
+std::string format(const Reply& reply);
+
+// Parse a single line, with or without its "\n" or "\r\n".
+outcome::result<Request> parse_request(std::string_view line);
+outcome::result<Reply> parse_reply(std::string_view line);
+
+}  // namespace protocol
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_GAME_PROTOCOL_H_
@@ -0,0 +1,239 @@
+#include "game_record.hpp"
+
+#include <algorithm>
+#include <array>
+#include <system_error>
+#include <utility>
+
+namespace tictactoe {
+
+namespace {
+
+constexpr std::array<std::uint8_t, 5> kMagic = {'T', 'T', 'T', 'R',
+                                                game_record::kVersion};
+
+// Largest side or win length in a header. The writer refuses rules beyond
+// it, so that every file it writes can be read back, and the decoder treats
+// larger values as corruption.
+constexpr int kMaxSide = 1 << 15;
+
+bool fits_header(const GameRules& rules) {
+  for (const int n : {rules.rows, rules.cols, rules.win_length}) {
+    if (n < 1 or n > kMaxSide) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+namespace game_record {
+
+Header make_header(const GameRules& rules) {
+  Header header{};
+  std::copy(kMagic.begin(), kMagic.end(), header.begin());
+  std::size_t at = 6;
+  for (const int n : {rules.rows, rules.cols, rules.win_length}) {
+    header[at++] = static_cast<std::uint8_t>(n & 0xFF);
+    header[at++] = static_cast<std::uint8_t>((n >> 8) & 0xFF);
+  }
+  return header;
+}
+
+outcome::result<GameRules> parse_header(std::span<const std::uint8_t> header) {
+  if (header.size() < kHeaderSize or
+      !std::equal(kMagic.begin(), kMagic.end(), header.begin())) {
+    return std::errc::illegal_byte_sequence;
+  }
+  std::array<int, 3> fields{};
+  std::size_t at = 6;
+  for (auto& n : fields) {
+    n = header[at] | (header[at + 1] << 8);
+    at += 2;
+    if (n < 1 or n > kMaxSide) {
+      return std::errc::illegal_byte_sequence;
+    }
+  }
+  return GameRules{fields[0], fields[1], fields[2]};
+}
+
+void append_varint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+  while (value >= 0x80U) {
+    out.push_back(static_cast<std::uint8_t>(value | 0x80U));
+    value >>= 7U;
+  }
+  out.push_back(static_cast<std::uint8_t>(value));
+}
+
+outcome::result<std::uint64_t> read_varint(std::span<const std::uint8_t> data,
+                                           std::size_t& offset) {
+  std::uint64_t value = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    if (offset >= data.size()) {
+      return std::errc::illegal_byte_sequence;
+    }
+    const std::uint8_t byte = data[offset++];
+    // the 10th byte holds only bit 63; anything more is out of range
+    if (shift == 63 and byte > 1) {
+      return std::errc::illegal_byte_sequence;
+    }
+    value |= std::uint64_t{byte & 0x7FU} << shift;
+    if ((byte & 0x80U) == 0) {
+      return value;
+    }
+  }
+  return std::errc::illegal_byte_sequence;
+}
+
+void encode(const GameRecord& record, std::vector<std::uint8_t>& out) {
+  // The length prefix comes first, so the payload size is computed up front.
+  std::size_t payload = 0;
+  const auto varint_size = [](std::uint64_t value) {
+    std::size_t bytes = 1;
+    while (value >= 0x80U) {
+      value >>= 7U;
+      ++bytes;
+    }
+    return bytes;
+  };
+  const auto unsigned_of = [](int v) { return static_cast<std::uint64_t>(v); };
+
+  for (const int move : record.moves) {
+    payload += varint_size(unsigned_of(move));
+  }
+
+  append_varint(out, payload);
+  for (const int move : record.moves) {
+    append_varint(out, unsigned_of(move));
+  }
+}
+
+}  // namespace game_record
+
+outcome::result<GameRecordWriter> GameRecordWriter::open(
+    const std::filesystem::path& path, const GameRules& rules) {
+  if (!fits_header(rules)) {
+    return std::errc::argument_out_of_domain;
+  }
+  std::FILE* file = std::fopen(path.string().c_str(), "ab");
+  if (file == nullptr) {
+    return std::errc::io_error;
+  }
+  GameRecordWriter writer{file, rules};
+
+  std::error_code ec;
+  const auto size = std::filesystem::file_size(path, ec);
+  if (ec) {
+    return ec;
+  }
+  if (size == 0) {
+    const auto header = game_record::make_header(rules);
+    if (std::fwrite(header.data(), 1, header.size(), file) != header.size()) {
+      return std::errc::io_error;
+    }
+    return writer;
+  }
+
+  // appending needs the header of the existing file, which "ab" cannot read
+  game_record::Header header{};
+  std::FILE* existing = std::fopen(path.string().c_str(), "rb");
+  if (existing == nullptr) {
+    return std::errc::io_error;
+  }
+  const auto read = std::fread(header.data(), 1, header.size(), existing);
+  std::fclose(existing);
+  const auto file_rules = OUTCOME_TRYX(
+      game_record::parse_header(std::span{header.data(), read}));
+  if (file_rules != rules) {
+    return std::errc::invalid_argument;
+  }
+  return writer;
+}
+
+GameRecordWriter::GameRecordWriter(GameRecordWriter&& other) noexcept
+    : file_{std::exchange(other.file_, nullptr)},
+      rules_{other.rules_},
+      buffer_{std::move(other.buffer_)} {}
+
+GameRecordWriter::~GameRecordWriter() {
+  if (file_ != nullptr) {
+    std::fclose(file_);
+  }
+}
+
+outcome::result<void> GameRecordWriter::append(const GameRecord& record) {
+  if (record.rules != rules_) {
+    return std::errc::invalid_argument;
+  }
+  buffer_.clear();
+  game_record::encode(record, buffer_);
+  return append_encoded(buffer_);
+}
+
+outcome::result<void> GameRecordWriter::append_encoded(
+    std::span<const std::uint8_t> records) {
+  if (std::fwrite(records.data(), 1, records.size(), file_) !=
+      records.size()) {
+    return std::errc::io_error;
+  }
+  return outcome::success();
+}
+
+outcome::result<void> GameRecordWriter::flush() {
+  if (std::fflush(file_) != 0) {
+    return std::errc::io_error;
+  }
+  return outcome::success();
+}
+
+outcome::result<GameRecordReader> GameRecordReader::create(
+    std::span<const std::uint8_t> file_bytes) {
+  const auto rules = OUTCOME_TRYX(game_record::parse_header(file_bytes));
+  return GameRecordReader{file_bytes, rules};
+}
+
+outcome::result<bool> GameRecordReader::next(GameRecord& record) {
+  if (offset_ == data_.size()) {
+    return false;
+  }
+
+  const auto length = OUTCOME_TRYX(game_record::read_varint(data_, offset_));
+  if (length > data_.size() - offset_) {
+    return std::errc::illegal_byte_sequence;
+  }
+  const auto payload = data_.subspan(offset_, static_cast<std::size_t>(length));
+  offset_ += payload.size();
+
+  std::size_t pos = 0;
+  record.rules = rules_;
+  const auto cells = static_cast<std::uint64_t>(rules_.num_cells());
+  record.moves.clear();
+  while (pos < payload.size()) {
+    const auto move = OUTCOME_TRYX(game_record::read_varint(payload, pos));
+    if (move >= cells) {
+      return std::errc::illegal_byte_sequence;
+    }
+    record.moves.push_back(static_cast<int>(move));
+  }
+  return true;
+}
+
+outcome::result<Engine> ReplayGame(const GameRecord& record,
+                                   std::size_t max_moves) {
+  auto engine = OUTCOME_TRYX(Engine::create_engine(record.rules));
+  const int cols = record.rules.cols;
+  for (std::size_t i = 0; i < record.moves.size() and i < max_moves; ++i) {
+    const int move = record.moves[i];
+    const auto pos = OUTCOME_TRYX(
+        Position::create_position_for_engine(move / cols, move % cols, engine));
+    // the engine silently ignores moves after a win
+    if (engine.maybe_winner()) {
+      return std::errc::invalid_argument;
+    }
+    OUTCOME_TRYV(engine.handle_field_selected(pos));
+  }
+  return engine;
+}
+
+}  // namespace tictactoe
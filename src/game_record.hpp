@@ -0,0 +1,117 @@
+#ifndef TICTACTOE_GAME_RECORD_H_
+#define TICTACTOE_GAME_RECORD_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <limits>
+#include <outcome.hpp>
+#include <span>
+#include <vector>
+
+#include "board.hpp"
+#include "engine.hpp"
+#include "mapped_file.hpp"
+
+namespace tictactoe {
+
+// A finished or unfinished game as the sequence of fields played, each as
+// the pos2idx index on a rules.cols wide board.
+struct GameRecord {
+  GameRules rules;
+  std::vector<int> moves;
+};
+
+// Game record files start with a 12 byte header: "TTTR", a version byte, a
+// padding byte, then rows, cols and win_length as little-endian 16-bit
+// numbers; every game in a file is played by these rules. Any number of
+// records follow, each a varint byte length followed by one varint per move,
+// so a full 3x3 game takes 10 bytes and most moves on boards up to 11x11 a
+// single byte. Files are only ever appended to, so a crash loses what was not
+// written out yet: the writer's stdio buffer, and in batch simulation up to
+// 64 KiB of records per thread; a record cut short is reported as truncated.
+namespace game_record {
+inline constexpr std::size_t kHeaderSize = 12;
+inline constexpr std::uint8_t kVersion = 2;
+
+using Header = std::array<std::uint8_t, kHeaderSize>;
+Header make_header(const GameRules& rules);
+// The rules of a file starting with header, if it is a valid header.
+outcome::result<GameRules> parse_header(std::span<const std::uint8_t> header);
+
+void append_varint(std::vector<std::uint8_t>& out, std::uint64_t value);
+// Decodes a varint at data[offset] and advances offset past it.
+outcome::result<std::uint64_t> read_varint(std::span<const std::uint8_t> data,
+                                           std::size_t& offset);
+
+// Appends the length-prefixed moves of record to out; its rules belong in the
+// header of the file.
+void encode(const GameRecord& record, std::vector<std::uint8_t>& out);
+}  // namespace game_record
+
+// Appends records to a file, writing the header first if the file is new.
+// An existing file has to hold games played by the same rules.
+class GameRecordWriter {
+ public:
+  static outcome::result<GameRecordWriter> open(
+      const std::filesystem::path& path, const GameRules& rules);
+
+  GameRecordWriter(GameRecordWriter&& other) noexcept;
+  GameRecordWriter& operator=(GameRecordWriter&&) = delete;
+  GameRecordWriter(const GameRecordWriter&) = delete;
+  GameRecordWriter& operator=(const GameRecordWriter&) = delete;
+  ~GameRecordWriter();
+
+  const GameRules& rules() const { return rules_; }
+
+  // Fails for a record played by rules other than rules().
+  outcome::result<void> append(const GameRecord& record);
+  // Appends records of games played by rules() that were already encoded
+  // with game_record::encode.
+  outcome::result<void> append_encoded(std::span<const std::uint8_t> records);
+  outcome::result<void> flush();
+
+ private:
+  GameRecordWriter(std::FILE* file, const GameRules& rules)
+      : file_{file}, rules_{rules} {}
+
+  std::FILE* file_;
+  GameRules rules_;
+  std::vector<std::uint8_t> buffer_;
+};
+
+// Streams records out of the bytes of a game record file, typically a
+// MappedFile opened for sequential access. Decoding into the same GameRecord
+// reuses its move buffer.
+class GameRecordReader {
+ public:
+  static outcome::result<GameRecordReader> create(
+      std::span<const std::uint8_t> file_bytes);
+
+  // The rules of every game in the file.
+  const GameRules& rules() const { return rules_; }
+
+  // Decodes the next record into record; returns false at the end of the
+  // data and an error for truncated or malformed records.
+  outcome::result<bool> next(GameRecord& record);
+
+ private:
+  GameRecordReader(std::span<const std::uint8_t> data, const GameRules& rules)
+      : data_{data}, rules_{rules}, offset_{game_record::kHeaderSize} {}
+
+  std::span<const std::uint8_t> data_;
+  GameRules rules_;
+  std::size_t offset_;
+};
+
+// Plays the first max_moves moves of record on a fresh engine. Fails if the
+// rules are invalid or a move is off the board or illegal.
+outcome::result<Engine> ReplayGame(
+    const GameRecord& record,
+    std::size_t max_moves = std::numeric_limits<std::size_t>::max());
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_GAME_RECORD_H_
@@ -0,0 +1,609 @@
+#include "game_server.hpp"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+
+#include "game_protocol.hpp"
+#include "latency_histogram.hpp"
+
+namespace tictactoe {
+
+namespace {
+
+constexpr int kPollTimeoutMs = 200;
+// The wake-up pipe and the listening socket come first in every poll set.
+constexpr std::size_t kFirstConnection = 2;
+// Client ids keep the index of the owning event loop in their low bits.
+constexpr unsigned kLoopBits = 16;
+constexpr std::uint64_t kLoopMask = (std::uint64_t{1} << kLoopBits) - 1;
+constexpr std::size_t kReadChunk = 4096;
+// Connections that stop reading their replies are dropped past this.
+constexpr std::size_t kMaxPendingOutput = std::size_t{1} << 20U;
+
+#if defined(MSG_NOSIGNAL)
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+std::error_code last_error() { return {errno, std::generic_category()}; }
+
+bool would_block() {
+#if EAGAIN != EWOULDBLOCK
+  if (errno == EWOULDBLOCK) {
+    return true;
+  }
+#endif
+  return errno == EAGAIN;
+}
+
+outcome::result<void> set_non_blocking(int fd) {
+  const int flags = ::fcntl(fd, F_GETFL, 0);
+  if (flags < 0 or ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0) {
+    return last_error();
+  }
+  return outcome::success();
+}
+
+}  // namespace
+
+struct GameServer::Connection {
+  ClientId id = 0;
+  int fd = -1;
+  // Where the connection is in its loop's poll set.
+  std::size_t slot = 0;
+  std::string in;
+  std::string out;
+  std::vector<std::uint64_t> games;
+  bool closed = false;
+};
+
+struct GameServer::Shard {
+  struct Game {
+    Engine engine;
+    ClientId cross;
+    ClientId circle;
+  };
+
+  std::mutex mutex;
+  std::unordered_map<std::uint64_t, Game> games;
+};
+
+class GameServer::EventLoop {
+ public:
+  EventLoop(GameServer& server, unsigned index)
+      : server_{server}, index_{index} {}
+
+  EventLoop(const EventLoop&) = delete;
+  EventLoop& operator=(const EventLoop&) = delete;
+
+  ~EventLoop() {
+    for (auto& [id, conn] : connections_) {
+      ::close(conn.fd);
+      --server_.connections_;
+    }
+    for (const int fd : adopted_) {
+      ::close(fd);
+      --server_.connections_;
+    }
+    for (const int fd : {wake_read_, wake_write_}) {
+      if (fd >= 0) {
+        ::close(fd);
+      }
+    }
+  }
+
+  outcome::result<void> open() {
+    int fds[2] = {-1, -1};
+    if (::pipe(fds) != 0) {
+      return last_error();
+    }
+    wake_read_ = fds[0];
+    wake_write_ = fds[1];
+    OUTCOME_TRYV(set_non_blocking(wake_read_));
+    OUTCOME_TRYV(set_non_blocking(wake_write_));
+    return outcome::success();
+  }
+
+  void run() {
+    // Only the first loop accepts, so a new connection wakes one thread;
+    // poll skips the negative descriptor of the others.
+    fds_.push_back(pollfd{wake_read_, POLLIN, 0});
+    fds_.push_back(pollfd{index_ == 0 ? server_.listen_fd_ : -1, POLLIN, 0});
+    fd_clients_.resize(kFirstConnection, 0);
+
+    while (!server_.stopping_) {
+      if (::poll(fds_.data(), fds_.size(), kPollTimeoutMs) < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        break;
+      }
+
+      if ((fds_[0].revents & POLLIN) != 0) {
+        drain_inbox();
+      }
+      if ((fds_[1].revents & POLLIN) != 0) {
+        accept_all();
+      }
+      // backwards, as closing a connection moves the last one, which was
+      // already handled, into its slot
+      for (auto i = fds_.size(); i-- > kFirstConnection;) {
+        const auto revents = fds_[i].revents;
+        const auto it = connections_.find(fd_clients_[i]);
+        if (it == connections_.end() or revents == 0) {
+          continue;
+        }
+        auto& conn = it->second;
+        if ((revents & (POLLIN | POLLHUP | POLLERR)) != 0) {
+          read_from(conn);
+        }
+        // replies to what was just read usually fit into the socket buffer
+        if (!conn.closed and !conn.out.empty()) {
+          write_to(conn);
+        }
+        if (conn.closed) {
+          close(it);
+        } else {
+          update_events(conn);
+        }
+      }
+    }
+  }
+
+  // Queues a line for one of this loop's connections from any thread.
+  void post(ClientId to, std::string line,
+            std::optional<std::uint64_t> ended) {
+    bool was_empty = false;
+    {
+      std::lock_guard lock{inbox_mutex_};
+      was_empty = inbox_.empty() and adopted_.empty();
+      inbox_.push_back(Message{to, std::move(line), ended});
+    }
+    if (was_empty) {
+      wake();
+    }
+  }
+
+  // Hands a newly accepted socket to this loop from the accepting one.
+  void adopt(int fd) {
+    bool was_empty = false;
+    {
+      std::lock_guard lock{inbox_mutex_};
+      was_empty = inbox_.empty() and adopted_.empty();
+      adopted_.push_back(fd);
+    }
+    if (was_empty) {
+      wake();
+    }
+  }
+
+  void wake() {
+    const char byte = 1;
+    // a full pipe already guarantees a wake-up
+    [[maybe_unused]] const auto written = ::write(wake_write_, &byte, 1);
+  }
+
+  Connection* find(ClientId id) {
+    const auto it = connections_.find(id);
+    return it == connections_.end() ? nullptr : &it->second;
+  }
+
+  // Queues line on a connection of this loop, if it is still open, and
+  // forgets the ended game.
+  void send(ClientId to, std::string line,
+            std::optional<std::uint64_t> ended) {
+    auto* conn = find(to);
+    if (conn == nullptr) {
+      return;
+    }
+    conn->out += line;
+    update_events(*conn);
+    if (ended) {
+      std::erase(conn->games, *ended);
+    }
+  }
+
+  LatencyHistogram latency;
+
+ private:
+  struct Message {
+    ClientId to;
+    std::string line;
+    std::optional<std::uint64_t> ended;
+  };
+
+  GameServer& server_;
+  unsigned index_;
+  int wake_read_ = -1;
+  int wake_write_ = -1;
+  std::unordered_map<ClientId, Connection> connections_;
+  // Kept up to date as connections come and go and their output drains, so
+  // a wake-up costs nothing per idle connection. fd_clients_ holds the
+  // client of each entry.
+  std::vector<pollfd> fds_;
+  std::vector<ClientId> fd_clients_;
+  // The loop the first loop hands its next connection to.
+  std::size_t next_loop_ = 0;
+  std::mutex inbox_mutex_;
+  std::vector<Message> inbox_;
+  std::vector<int> adopted_;
+
+  void update_events(const Connection& conn) {
+    fds_[conn.slot].events =
+        static_cast<short>(conn.out.empty() ? POLLIN : POLLIN | POLLOUT);
+  }
+
+  void add_connection(int fd) {
+    Connection conn;
+    conn.id = (server_.next_client_++ << kLoopBits) | index_;
+    conn.fd = fd;
+    conn.slot = fds_.size();
+    fds_.push_back(pollfd{fd, POLLIN, 0});
+    fd_clients_.push_back(conn.id);
+    connections_.emplace(conn.id, std::move(conn));
+  }
+
+  void drain_inbox() {
+    char buffer[64];
+    while (::read(wake_read_, buffer, sizeof(buffer)) > 0) {
+    }
+    std::vector<Message> messages;
+    std::vector<int> adopted;
+    {
+      std::lock_guard lock{inbox_mutex_};
+      messages.swap(inbox_);
+      adopted.swap(adopted_);
+    }
+    for (const int fd : adopted) {
+      add_connection(fd);
+    }
+    for (auto& message : messages) {
+      send(message.to, std::move(message.line), message.ended);
+    }
+  }
+
+  // Runs on the first loop only and deals the connections out to all loops
+  // in turn.
+  void accept_all() {
+    while (true) {
+      const int fd = ::accept(server_.listen_fd_, nullptr, nullptr);
+      if (fd < 0) {
+        return;
+      }
+      if (!set_non_blocking(fd)) {
+        ::close(fd);
+        continue;
+      }
+      const int one = 1;
+      ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+      ++server_.connections_;
+
+      auto& loop = *server_.loops_[next_loop_];
+      next_loop_ = (next_loop_ + 1) % server_.loops_.size();
+      if (&loop == this) {
+        add_connection(fd);
+      } else {
+        loop.adopt(fd);
+      }
+    }
+  }
+
+  void read_from(Connection& conn) {
+    char buffer[kReadChunk];
+    const auto n = ::read(conn.fd, buffer, sizeof(buffer));
+    if (n == 0 or (n < 0 and !would_block() and errno != EINTR)) {
+      conn.closed = true;
+      return;
+    }
+    if (n < 0) {
+      return;
+    }
+    conn.in.append(buffer, static_cast<std::size_t>(n));
+
+    std::size_t start = 0;
+    for (auto end = conn.in.find('\n'); end != std::string::npos;
+         end = conn.in.find('\n', start)) {
+      server_.handle_line(*this, conn,
+                          std::string_view{conn.in}.substr(start, end - start));
+      start = end + 1;
+    }
+    conn.in.erase(0, start);
+    if (conn.in.size() >= protocol::kMaxLineLength) {
+      conn.closed = true;
+    }
+  }
+
+  void write_to(Connection& conn) {
+    const auto n =
+        ::send(conn.fd, conn.out.data(), conn.out.size(), kSendFlags);
+    if (n > 0) {
+      conn.out.erase(0, static_cast<std::size_t>(n));
+    } else if (n < 0 and !would_block() and errno != EINTR) {
+      conn.closed = true;
+    }
+    if (conn.out.size() > kMaxPendingOutput) {
+      conn.closed = true;
+    }
+  }
+
+  void close(std::unordered_map<ClientId, Connection>::iterator it) {
+    auto& conn = it->second;
+    for (const auto game : conn.games) {
+      server_.leave_game(*this, conn.id, game);
+    }
+    ::close(conn.fd);
+
+    // the last entry of the poll set takes the place of the closed one
+    const auto slot = conn.slot;
+    if (slot != fds_.size() - 1) {
+      fds_[slot] = fds_.back();
+      fd_clients_[slot] = fd_clients_.back();
+      connections_.at(fd_clients_[slot]).slot = slot;
+    }
+    fds_.pop_back();
+    fd_clients_.pop_back();
+
+    connections_.erase(it);
+    --server_.connections_;
+  }
+};
+
+GameServer::GameServer(const ServerOptions& options)
+    : max_games_per_connection_{options.max_games_per_connection},
+      started_{std::chrono::steady_clock::now()} {
+  const unsigned shards = std::max(1U, options.shards);
+  for (unsigned s = 0; s < shards; ++s) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+}
+
+outcome::result<std::unique_ptr<GameServer>> GameServer::start(
+    const ServerOptions& options) {
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(options.port);
+  if (::inet_pton(AF_INET, options.bind_address.c_str(), &address.sin_addr) !=
+      1) {
+    return std::errc::invalid_argument;
+  }
+
+  // private constructor, so no std::make_unique
+  std::unique_ptr<GameServer> server{new GameServer{options}};
+  server->listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (server->listen_fd_ < 0) {
+    return last_error();
+  }
+  const int one = 1;
+  ::setsockopt(server->listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one,
+               sizeof(one));
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  auto* generic = reinterpret_cast<sockaddr*>(&address);
+  socklen_t length = sizeof(address);
+  if (::bind(server->listen_fd_, generic, length) != 0 or
+      ::listen(server->listen_fd_, SOMAXCONN) != 0 or
+      ::getsockname(server->listen_fd_, generic, &length) != 0) {
+    return last_error();
+  }
+  OUTCOME_TRYV(set_non_blocking(server->listen_fd_));
+  server->port_ = ntohs(address.sin_port);
+
+  const unsigned threads =
+      options.threads > 0
+          ? std::min(options.threads, static_cast<unsigned>(kLoopMask))
+          : std::max(1U, std::thread::hardware_concurrency());
+  for (unsigned t = 0; t < threads; ++t) {
+    server->loops_.push_back(std::make_unique<EventLoop>(*server, t));
+    OUTCOME_TRYV(server->loops_.back()->open());
+  }
+  for (auto& loop : server->loops_) {
+    server->threads_.emplace_back([&loop = *loop] { loop.run(); });
+  }
+  return server;
+}
+
+GameServer::~GameServer() { stop(); }
+
+void GameServer::stop() {
+  stopping_ = true;
+  for (auto& loop : loops_) {
+    loop->wake();
+  }
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+  threads_.clear();
+  loops_.clear();
+  if (listen_fd_ >= 0) {
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+  }
+}
+
+ServerMetrics GameServer::metrics() const {
+  LatencyHistogram latency;
+  for (const auto& loop : loops_) {
+    latency.add(loop->latency);
+  }
+
+  ServerMetrics m;
+  m.connections = connections_;
+  m.games_created = games_created_;
+  m.games_active = games_active_;
+  m.requests = requests_;
+  m.moves = moves_;
+  m.latency_p50_ns = latency.percentile(0.50);
+  m.latency_p99_ns = latency.percentile(0.99);
+  m.uptime = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - started_);
+  return m;
+}
+
+GameServer::Shard& GameServer::shard_of(std::uint64_t game) {
+  return *shards_[game % shards_.size()];
+}
+
+void GameServer::deliver(EventLoop& from, ClientId to, std::string line,
+                         std::optional<std::uint64_t> ended) {
+  auto& loop = *loops_[to & kLoopMask];
+  if (&loop != &from) {
+    loop.post(to, std::move(line), ended);
+  } else {
+    loop.send(to, std::move(line), ended);
+  }
+}
+
+void GameServer::leave_game(EventLoop& loop, ClientId client,
+                            std::uint64_t game) {
+  ClientId opponent = client;
+  {
+    auto& shard = shard_of(game);
+    std::lock_guard lock{shard.mutex};
+    const auto it = shard.games.find(game);
+    if (it == shard.games.end()) {
+      return;
+    }
+    opponent = it->second.cross == client ? it->second.circle
+                                          : it->second.cross;
+    shard.games.erase(it);
+  }
+  --games_active_;
+  if (opponent != client) {
+    deliver(loop, opponent, protocol::format(protocol::GameLeft{game}), game);
+  }
+}
+
+void GameServer::handle_line(EventLoop& loop, Connection& conn,
+                             std::string_view line) {
+  using namespace protocol;
+  const auto start = std::chrono::steady_clock::now();
+  ++requests_;
+
+  // messages for other connections, sent once the shard is unlocked
+  std::vector<std::pair<ClientId, std::string>> outbox;
+  const auto reply = [&](const Reply& r) { conn.out += format(r); };
+  const auto fail = [&](std::string reason) {
+    reply(Error{std::move(reason)});
+  };
+
+  const auto request = parse_request(line);
+  if (!request) {
+    fail("malformed request");
+  } else if (const auto* create = std::get_if<NewGame>(&request.value())) {
+    auto engine = Engine::create_engine(create->rules);
+    if (!engine) {
+      fail("invalid rules");
+    } else if (conn.games.size() >= max_games_per_connection_) {
+      fail("too many games");
+    } else {
+      const auto id = next_game_++;
+      {
+        auto& shard = shard_of(id);
+        std::lock_guard lock{shard.mutex};
+        shard.games.emplace(
+            id, Shard::Game{std::move(engine).value(), conn.id, conn.id});
+      }
+      ++games_created_;
+      ++games_active_;
+      conn.games.push_back(id);
+      reply(GameJoined{id, Seat::Both, create->rules});
+    }
+  } else if (const auto* join = std::get_if<JoinGame>(&request.value())) {
+    auto& shard = shard_of(join->game);
+    std::lock_guard lock{shard.mutex};
+    const auto it = shard.games.find(join->game);
+    if (it == shard.games.end()) {
+      fail("no such game");
+    } else if (it->second.cross == conn.id) {
+      fail("already playing");
+    } else if (it->second.cross != it->second.circle) {
+      fail("game is full");
+    } else if (conn.games.size() >= max_games_per_connection_) {
+      fail("too many games");
+    } else {
+      auto& game = it->second;
+      const auto& rules = game.engine.rules();
+      game.circle = conn.id;
+      conn.games.push_back(join->game);
+      outbox.emplace_back(game.cross,
+                          format(GameJoined{join->game, Seat::Cross, rules}));
+      reply(GameJoined{join->game, Seat::Circle, rules});
+      for (const int cell : game.engine.move_history()) {
+        reply(MoveMade{join->game, cell / rules.cols, cell % rules.cols});
+      }
+    }
+  } else if (const auto* move = std::get_if<MakeMove>(&request.value())) {
+    auto& shard = shard_of(move->game);
+    std::lock_guard lock{shard.mutex};
+    const auto it = shard.games.find(move->game);
+    if (it == shard.games.end()) {
+      fail("no such game");
+    } else {
+      auto& game = it->second;
+      const auto mover = game.engine.get_active_player() == Player::CrossPlayer
+                             ? game.cross
+                             : game.circle;
+      const auto pos = Position::create_position_for_engine(
+          move->row, move->col, game.engine);
+      if (game.engine.maybe_winner()) {
+        fail("game is over");
+      } else if (mover != conn.id) {
+        fail("not your turn");
+      } else if (!pos or !game.engine.handle_field_selected(pos.value())) {
+        fail("illegal move");
+      } else {
+        ++moves_;
+        auto moved = format(MoveMade{move->game, move->row, move->col});
+        if (game.circle != game.cross) {
+          outbox.emplace_back(game.cross == conn.id ? game.circle
+                                                    : game.cross,
+                              moved);
+        }
+        conn.out += moved;
+      }
+    }
+  } else if (const auto* leave = std::get_if<LeaveGame>(&request.value())) {
+    const auto it =
+        std::find(conn.games.begin(), conn.games.end(), leave->game);
+    if (it == conn.games.end()) {
+      fail("not in game");
+    } else {
+      conn.games.erase(it);
+      leave_game(loop, conn.id, leave->game);
+      reply(GameLeft{leave->game});
+    }
+  } else {
+    const auto m = metrics();
+    reply(StatsReport{{{"connections", m.connections},
+                       {"games_created", m.games_created},
+                       {"games_active", m.games_active},
+                       {"requests", m.requests},
+                       {"moves", m.moves},
+                       {"latency_p50_ns", m.latency_p50_ns},
+                       {"latency_p99_ns", m.latency_p99_ns}}});
+  }
+
+  for (auto& [to, message] : outbox) {
+    deliver(loop, to, std::move(message));
+  }
+  loop.latency.record(static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start)
+          .count()));
+}
+
+}  // namespace tictactoe
@@ -0,0 +1,107 @@
+#ifndef TICTACTOE_GAME_SERVER_H_
+#define TICTACTOE_GAME_SERVER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <outcome.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "engine.hpp"
+
+namespace tictactoe {
+
+struct ServerOptions {
+  std::string bind_address = "127.0.0.1";
+  // 0 lets the system pick a free port, see GameServer::port().
+  std::uint16_t port = 7878;
+  // Event loop threads; 0 uses std::thread::hardware_concurrency().
+  unsigned threads = 0;
+  // Independently locked partitions of the game table.
+  unsigned shards = 64;
+  // Games one connection may be in at once; NEW and JOIN are refused
+  // beyond that.
+  std::size_t max_games_per_connection = 16;
+};
+
+struct ServerMetrics {
+  std::uint64_t connections = 0;
+  std::uint64_t games_created = 0;
+  std::uint64_t games_active = 0;
+  std::uint64_t requests = 0;
+  std::uint64_t moves = 0;
+  // Time from reading a request off the socket to queueing its replies.
+  std::uint64_t latency_p50_ns = 0;
+  std::uint64_t latency_p99_ns = 0;
+  std::chrono::microseconds uptime{0};
+
+  double requests_per_second() const {
+    const auto us = static_cast<double>(uptime.count());
+    return us > 0.0 ? static_cast<double>(requests) * 1e6 / us : 0.0;
+  }
+};
+
+// Headless host for many concurrent games speaking the line protocol of
+// game_protocol.hpp over TCP. The first event loop thread accepts new
+// connections and deals them out to all loops in turn; every loop polls only
+// the connections it owns. Each game has its own Engine, and games
+// are spread over shards so that moves in different games rarely contend for
+// the same lock. Replies for connections owned by another loop are queued
+// there and the loop is woken up.
+class GameServer {
+ public:
+  static outcome::result<std::unique_ptr<GameServer>> start(
+      const ServerOptions& options);
+
+  GameServer(const GameServer&) = delete;
+  GameServer& operator=(const GameServer&) = delete;
+  ~GameServer();
+
+  std::uint16_t port() const { return port_; }
+  ServerMetrics metrics() const;
+
+  // Closes every connection and joins the event loops.
+  void stop();
+
+ private:
+  class EventLoop;
+  struct Shard;
+  struct Connection;
+  using ClientId = std::uint64_t;
+
+  explicit GameServer(const ServerOptions& options);
+
+  void handle_line(EventLoop& loop, Connection& conn, std::string_view line);
+  void leave_game(EventLoop& loop, ClientId client, std::uint64_t game);
+  // Queues line for a client. ended, if set, is a game the client is no
+  // longer in.
+  void deliver(EventLoop& from, ClientId to, std::string line,
+               std::optional<std::uint64_t> ended = std::nullopt);
+  Shard& shard_of(std::uint64_t game);
+
+  std::size_t max_games_per_connection_;
+  int listen_fd_ = -1;
+  std::uint16_t port_ = 0;
+  std::chrono::steady_clock::time_point started_;
+  std::atomic<bool> stopping_ = false;
+  std::vector<std::unique_ptr<EventLoop>> loops_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::vector<std::thread> threads_;
+
+  std::atomic<std::uint64_t> next_game_ = 1;
+  std::atomic<std::uint64_t> next_client_ = 1;
+  std::atomic<std::uint64_t> connections_ = 0;
+  std::atomic<std::uint64_t> games_created_ = 0;
+  std::atomic<std::uint64_t> games_active_ = 0;
+  std::atomic<std::uint64_t> requests_ = 0;
+  std::atomic<std::uint64_t> moves_ = 0;
+};
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_GAME_SERVER_H_
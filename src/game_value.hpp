@@ -0,0 +1,15 @@
+#ifndef TICTACTOE_GAME_VALUE_H_
+#define TICTACTOE_GAME_VALUE_H_
+
+namespace tictactoe {
+
+// The outcome of a position with perfect play by both sides.
+enum class GameValue {
+  Loss = -1,
+  Draw = 0,
+  Win = 1,
+};
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_GAME_VALUE_H_
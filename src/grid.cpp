@@ -0,0 +1,316 @@
+#include "grid.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+#include "metrics.hpp"
+#include "solarized.hpp"
+
+namespace tictactoe {
+
+namespace {
+constexpr std::size_t kVerticesPerQuad = 4;
+constexpr std::size_t kBackgroundVertices = kVerticesPerQuad;
+constexpr std::size_t kBytesPerTexel = 4;
+// Larger boards put a block of fields into each occupancy texel.
+constexpr int kMaxOccupancyTexels = 1024;
+// Below this many pixels per field the marks are no longer recognisable and
+// the occupancy texture is drawn instead.
+constexpr float kMinFieldPixels = 4.0f;
+
+int occupancy_scale_for(int rows, int cols) {
+  const int side = std::max(rows, cols);
+  return (side + kMaxOccupancyTexels - 1) / kMaxOccupancyTexels;
+}
+
+unsigned texels_for(int fields, int scale) {
+  return static_cast<unsigned>((fields + scale - 1) / scale);
+}
+}  // namespace
+
+Grid::Grid(const Configuration& config, Engine& engine,
+           TextureCache& textures)
+    : engine_{engine},
+      num_rows_{engine.rows()},
+      num_cols_{engine.cols()},
+      num_boxes_total_{num_rows_ * num_cols_},
+      vertices_{sf::Quads,
+                kBackgroundVertices +
+                    kVerticesPerQuad *
+                        static_cast<std::size_t>(num_boxes_total_)},
+      atlas_{textures.mark_atlas(config.asset_dir)},
+      occupancy_scale_{occupancy_scale_for(num_rows_, num_cols_)},
+      occupancy_size_{texels_for(num_cols_, occupancy_scale_),
+                      texels_for(num_rows_, occupancy_scale_)},
+      occupancy_pixels_(kBytesPerTexel * occupancy_size_.x *
+                        occupancy_size_.y) {
+  const auto board_size = get_board_size();
+  vertices_[0].position = sf::Vector2f{0.0f, 0.0f};
+  vertices_[1].position = sf::Vector2f{board_size.x, 0.0f};
+  vertices_[2].position = board_size;
+  vertices_[3].position = sf::Vector2f{0.0f, board_size.y};
+
+  std::size_t v = kBackgroundVertices;
+  for (int row = 0; row < num_rows_; ++row) {
+    for (int col = 0; col < num_cols_; ++col) {
+      const float left = GridLayout::field_start(col);
+      const float top = GridLayout::field_start(row);
+      constexpr float side_size = GridLayout::side_size;
+
+      vertices_[v++].position = sf::Vector2f{left, top};
+      vertices_[v++].position = sf::Vector2f{left + side_size, top};
+      vertices_[v++].position =
+          sf::Vector2f{left + side_size, top + side_size};
+      vertices_[v++].position = sf::Vector2f{left, top + side_size};
+    }
+  }
+
+  occupancy_.create(occupancy_size_.x, occupancy_size_.y);
+  // filtering averages neighbouring texels when the board is shrunk further
+  occupancy_.setSmooth(true);
+  const auto scale = static_cast<float>(occupancy_scale_);
+  const sf::Vector2f texels{static_cast<float>(num_cols_) / scale,
+                            static_cast<float>(num_rows_) / scale};
+  occupancy_quad_ = {
+      sf::Vertex{{0.0f, 0.0f}, sf::Color::White, {0.0f, 0.0f}},
+      sf::Vertex{{board_size.x, 0.0f}, sf::Color::White, {texels.x, 0.0f}},
+      sf::Vertex{board_size, sf::Color::White, texels},
+      sf::Vertex{{0.0f, board_size.y}, sf::Color::White, {0.0f, texels.y}}};
+
+  spdlog::info("current working dir is {}", fs::current_path().string());
+  // already loaded when another grid shares the atlas
+  atlas_ready_ = atlas_->ready();
+
+  auto result = update_grid();
+  if (!result) {
+    spdlog::error("initial grid update failed: {}", result.error().message());
+  }
+}
+
+bool Grid::update_assets() {
+  if (atlas_ready_ or !atlas_->ready()) {
+    return false;
+  }
+  atlas_ready_ = true;
+  auto result = update_grid();
+  if (!result) {
+    spdlog::error("grid update failed: {}", result.error().message());
+  }
+  return true;
+}
+
+outcome::result<void> Grid::update_grid() {
+  static auto& timing = metrics::Registry::global().timing(
+      "tictactoe_grid_update_seconds", "Time Grid::update_grid takes");
+  const metrics::ScopedTimer timer{timing};
+
+  for (int row = 0; row < num_rows_; ++row) {
+    for (int col = 0; col < num_cols_; ++col) {
+      update_quad(
+          OUTCOME_TRYX(Position::create_position_for_engine(row, col, engine_)));
+    }
+  }
+  update_background();
+
+  for (unsigned y = 0; y < occupancy_size_.y; ++y) {
+    for (unsigned x = 0; x < occupancy_size_.x; ++x) {
+      write_occupancy_texel(static_cast<int>(y), static_cast<int>(x));
+    }
+  }
+  occupancy_.update(occupancy_pixels_.data());
+
+  return outcome::success();
+}
+
+void Grid::update_field(const Position& pos) {
+  update_quad(pos);
+  update_background();
+
+  const int block_row = pos.row() / occupancy_scale_;
+  const int block_col = pos.col() / occupancy_scale_;
+  const auto texel = write_occupancy_texel(block_row, block_col);
+  occupancy_.update(&occupancy_pixels_[texel], 1, 1,
+                    static_cast<unsigned>(block_col),
+                    static_cast<unsigned>(block_row));
+}
+
+std::size_t Grid::write_occupancy_texel(int block_row, int block_col) {
+  int crosses = 0;
+  int circles = 0;
+  const int first_row = block_row * occupancy_scale_;
+  const int first_col = block_col * occupancy_scale_;
+  for (int row = first_row;
+       row < std::min(num_rows_, first_row + occupancy_scale_); ++row) {
+    for (int col = first_col;
+         col < std::min(num_cols_, first_col + occupancy_scale_); ++col) {
+      const auto pos =
+          Position::create_position_for_engine(row, col, engine_).value();
+      switch (engine_.get_field_state_at(pos)) {
+        case FieldState::Cross:
+          ++crosses;
+          break;
+        case FieldState::Circle:
+          ++circles;
+          break;
+        case FieldState::Empty:
+          break;
+      }
+    }
+  }
+
+  // the colours of the placeholders drawn while the atlas loads; empty
+  // texels let the background show through
+  sf::Color color = Solarized::base3;
+  color.a = 0;
+  if (crosses + circles > 0) {
+    color = crosses >= circles ? Solarized::base01 : Solarized::base1;
+  }
+
+  const auto texel =
+      kBytesPerTexel * (static_cast<std::size_t>(block_row) *
+                            occupancy_size_.x +
+                        static_cast<std::size_t>(block_col));
+  occupancy_pixels_[texel + 0] = color.r;
+  occupancy_pixels_[texel + 1] = color.g;
+  occupancy_pixels_[texel + 2] = color.b;
+  occupancy_pixels_[texel + 3] = color.a;
+  return texel;
+}
+
+void Grid::update_quad(const Position& pos) {
+  const auto first_vertex =
+      kBackgroundVertices +
+      kVerticesPerQuad * pos2idx(pos.row(), pos.col(), num_cols_);
+
+  // texture coordinates are ignored while drawing without the atlas
+  switch (engine_.get_field_state_at(pos)) {
+    case FieldState::Empty:
+      set_quad(first_vertex, atlas_->blank_uv(), Solarized::base3);
+      break;
+    case FieldState::Circle:
+      set_quad(first_vertex, atlas_->circle_uv(),
+               atlas_ready_ ? Solarized::base00 : Solarized::base1);
+      break;
+    case FieldState::Cross:
+      set_quad(first_vertex, atlas_->cross_uv(),
+               atlas_ready_ ? Solarized::base00 : Solarized::base01);
+      break;
+  }
+}
+
+void Grid::update_background() {
+  sf::Color color = Solarized::base3;
+  if (auto w = engine_.maybe_winner()) {
+    switch (*w) {
+      case Player::CrossPlayer:
+        color = Solarized::magenta;
+        break;
+      case Player::CirclePlayer:
+        color = Solarized::green;
+        break;
+    }
+  }
+  set_quad(0, atlas_->blank_uv(), color);
+}
+
+void Grid::set_quad(std::size_t first_vertex, const sf::FloatRect& uv,
+                    sf::Color color) {
+  const float right = uv.left + uv.width;
+  const float bottom = uv.top + uv.height;
+  vertices_[first_vertex + 0].texCoords = sf::Vector2f{uv.left, uv.top};
+  vertices_[first_vertex + 1].texCoords = sf::Vector2f{right, uv.top};
+  vertices_[first_vertex + 2].texCoords = sf::Vector2f{right, bottom};
+  vertices_[first_vertex + 3].texCoords = sf::Vector2f{uv.left, bottom};
+  for (std::size_t i = 0; i < kVerticesPerQuad; ++i) {
+    vertices_[first_vertex + i].color = color;
+  }
+}
+
+void Grid::draw_on(sf::RenderTarget& target) const {
+  // only queues the draw call; the GPU work shows up in the frame time
+  static auto& timing = metrics::Registry::global().timing(
+      "tictactoe_grid_draw_seconds", "Time Grid::draw_on takes");
+  const metrics::ScopedTimer timer{timing};
+
+  const sf::RenderStates states{atlas_ready_ ? &atlas_->texture() : nullptr};
+  target.draw(&vertices_[0], kBackgroundVertices, sf::Quads, states);
+
+  const auto& view = target.getView();
+  const auto viewport_pixels =
+      static_cast<float>(target.getViewport(view).width);
+  const float field_pixels =
+      GridLayout::side_size * viewport_pixels / view.getSize().x;
+  if (field_pixels < kMinFieldPixels) {
+    target.draw(occupancy_quad_.data(), occupancy_quad_.size(), sf::Quads,
+                sf::RenderStates{&occupancy_});
+    return;
+  }
+  draw_fields(target, states);
+}
+
+// Rows are contiguous in the vertex array, so the visible part of each row is
+// one draw call; when whole rows are visible all of them are.
+void Grid::draw_fields(sf::RenderTarget& target,
+                       const sf::RenderStates& states) const {
+  const auto& view = target.getView();
+  const auto top_left = view.getCenter() - view.getSize() * 0.5f;
+  const auto [first_col, last_col] = GridLayout::visible_fields(
+      top_left.x, top_left.x + view.getSize().x, num_cols_);
+  const auto [first_row, last_row] = GridLayout::visible_fields(
+      top_left.y, top_left.y + view.getSize().y, num_rows_);
+
+  const auto quads = [](int fields) {
+    return kVerticesPerQuad * static_cast<std::size_t>(fields);
+  };
+  const auto first_vertex = [this](int row, int col) {
+    return kBackgroundVertices +
+           kVerticesPerQuad * pos2idx(row, col, num_cols_);
+  };
+
+  if (first_col == last_col or first_row == last_row) {
+    return;
+  }
+  if (first_col == 0 and last_col == num_cols_) {
+    target.draw(&vertices_[first_vertex(first_row, 0)],
+                quads((last_row - first_row) * num_cols_), sf::Quads, states);
+    return;
+  }
+  for (int row = first_row; row < last_row; ++row) {
+    target.draw(&vertices_[first_vertex(row, first_col)],
+                quads(last_col - first_col), sf::Quads, states);
+  }
+}
+
+outcome::result<void> Grid::handle_click(const sf::Vector2f& location) {
+  static auto& timing = metrics::Registry::global().timing(
+      "tictactoe_grid_click_seconds",
+      "Time Grid::handle_click takes, including the engine move");
+  const metrics::ScopedTimer timer{timing};
+
+  if (const auto pos = field_at(location)) {
+    OUTCOME_TRYV(engine_.handle_field_selected(*pos));
+    update_field(*pos);
+  }
+  return outcome::success();
+}
+
+std::optional<Position> Grid::field_at(const sf::Vector2f& location) const {
+  const auto field =
+      GridLayout::field_at(location.x, location.y, num_rows_, num_cols_);
+  if (!field) {
+    return std::nullopt;
+  }
+  auto pos = Position::create_position_for_engine(*field, engine_);
+  if (!pos) {
+    return std::nullopt;
+  }
+  return pos.value();
+}
+
+sf::Vector2f Grid::get_board_size() const {
+  return sf::Vector2f{GridLayout::extent(num_cols_),
+                      GridLayout::extent(num_rows_)};
+}
+
+}  // namespace tictactoe
@@ -0,0 +1,83 @@
+#ifndef TICTACTOE_GRID_H_
+#define TICTACTOE_GRID_H_
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <outcome.hpp>
+#include <vector>
+
+#include "configuration.hpp"
+#include "engine.hpp"
+#include "grid_layout.hpp"
+#include "texture_cache.hpp"
+
+namespace tictactoe {
+
+// Draws the board of an Engine and turns clicks in world coordinates into
+// moves. The background and every field are quads of a single vertex array
+// textured from one atlas holding both marks, so the board is one draw call.
+// The quads are laid out once on construction, background first and then the
+// fields in row-major order (see pos2idx); afterwards only their colours and
+// texture coordinates change. The atlas comes from a TextureCache and is
+// decoded in the background; until it arrives the fields are drawn as plain
+// coloured squares.
+//
+// Only the fields inside the target's view are submitted. Once fields get
+// smaller than a few pixels, the board is drawn from an occupancy texture
+// instead, one texel per field (or per block of fields on huge boards), that
+// is kept up to date alongside the vertices.
+class Grid {
+  Engine& engine_;
+  int num_rows_;
+  int num_cols_;
+  int num_boxes_total_;
+  sf::VertexArray vertices_;
+
+  std::shared_ptr<MarkAtlas> atlas_;
+  bool atlas_ready_ = false;
+
+  // Fields along each side of the square block one occupancy texel covers.
+  int occupancy_scale_;
+  sf::Vector2u occupancy_size_;
+  std::vector<std::uint8_t> occupancy_pixels_;
+  sf::Texture occupancy_;
+  std::array<sf::Vertex, 4> occupancy_quad_;
+
+  void set_quad(std::size_t first_vertex, const sf::FloatRect& uv,
+                sf::Color color);
+  void update_background();
+  void update_quad(const Position& pos);
+  // Recomputes the occupancy texel of a block of fields from the engine and
+  // returns the offset of its first byte in occupancy_pixels_.
+  std::size_t write_occupancy_texel(int block_row, int block_col);
+  void draw_fields(sf::RenderTarget& target,
+                   const sf::RenderStates& states) const;
+
+ public:
+  Grid(const Configuration& config, Engine& engine,
+       TextureCache& textures = TextureCache::shared());
+
+  // Switches to the textured marks once the atlas is loaded. Returns true
+  // on the call that did, when the board has to be redrawn.
+  bool update_assets();
+  bool assets_loading() const { return !atlas_ready_; }
+
+  // Refreshes every field from the engine without reallocating anything.
+  outcome::result<void> update_grid();
+  // Refreshes the single field at pos, e.g. after a move was made there.
+  void update_field(const Position& pos);
+  void draw_on(sf::RenderTarget& target) const;
+  outcome::result<void> handle_click(const sf::Vector2f& location);
+  // The field under a world location, without playing it.
+  std::optional<Position> field_at(const sf::Vector2f& location) const;
+
+  sf::Vector2f get_board_size() const;
+};
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_GRID_H_
@@ -0,0 +1,75 @@
+#ifndef TICTACTOE_GRID_LAYOUT_H_
+#define TICTACTOE_GRID_LAYOUT_H_
+
+#include <algorithm>
+#include <optional>
+#include <tuple>
+#include <utility>
+
+namespace tictactoe {
+
+// World-space geometry of the board: square fields of side_size laid out on
+// a regular lattice, with a gap of offset around and between them.
+struct GridLayout {
+  static constexpr float side_size = 10.0f;
+  static constexpr float offset_factor = 0.1f;
+  static constexpr float offset = side_size * offset_factor;
+  static constexpr float spacing = side_size + offset;
+
+  static constexpr float extent(int fields) {
+    return offset + spacing * static_cast<float>(fields);
+  }
+
+  static constexpr float field_start(int index) {
+    return offset + spacing * static_cast<float>(index);
+  }
+
+  // Index of the field covering coordinate v along one axis, or nothing when
+  // v lies in a gap or outside the board. Fields are half-open intervals
+  // [start, start + side_size), matching sf::Rect::contains.
+  static constexpr std::optional<int> field_index(float v, int fields) {
+    const float local = v - offset;
+    // written so that NaN is rejected as well
+    if (!(local >= 0.0f and local < spacing * static_cast<float>(fields))) {
+      return std::nullopt;
+    }
+    const int index = static_cast<int>(local / spacing);
+    if (index >= fields or local - spacing * static_cast<float>(index) >=
+                               side_size) {
+      return std::nullopt;
+    }
+    return index;
+  }
+
+  // Half-open range [first, last) of the fields along one axis that overlap
+  // the interval [lo, hi), plus a field starting exactly at hi; empty when
+  // there is none.
+  static constexpr std::pair<int, int> visible_fields(float lo, float hi,
+                                                      int fields) {
+    const auto clamped = [fields](float index) {
+      // clamping as float first keeps huge coordinates from overflowing
+      return static_cast<int>(
+          std::clamp(index, 0.0f, static_cast<float>(fields)));
+    };
+    // field i covers [offset + spacing * i, offset + spacing * i + side_size)
+    const int first = clamped((lo - offset - side_size) / spacing + 1.0f);
+    const int last = clamped((hi - offset) / spacing + 1.0f);
+    return {first, std::max(first, last)};
+  }
+
+  // (row, column) of the field under the world coordinate (x, y).
+  static constexpr std::optional<std::tuple<int, int>> field_at(float x, float y,
+                                                                int rows,
+                                                                int cols) {
+    const auto col = field_index(x, cols);
+    const auto row = field_index(y, rows);
+    if (!col or !row) {
+      return std::nullopt;
+    }
+    return std::tuple{*row, *col};
+  }
+};
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_GRID_LAYOUT_H_
@@ -0,0 +1,222 @@
+#include "input_script.hpp"
+
+#include <array>
+#include <charconv>
+#include <cstdio>
+#include <random>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace tictactoe {
+
+namespace {
+
+// Words of a line are separated by any number of spaces or tabs.
+std::string_view next_word(std::string_view& rest) {
+  const auto begin = rest.find_first_not_of(" \t\r");
+  if (begin == std::string_view::npos) {
+    rest = {};
+    return {};
+  }
+  rest.remove_prefix(begin);
+  const auto end = rest.find_first_of(" \t\r");
+  const auto word = rest.substr(0, end);
+  rest.remove_prefix(word.size());
+  return word;
+}
+
+template <typename T>
+outcome::result<T> next_number(std::string_view& rest) {
+  const auto word = next_word(rest);
+  T value{};
+  const auto [end, ec] =
+      std::from_chars(word.data(), word.data() + word.size(), value);
+  if (word.empty() or ec != std::errc{} or end != word.data() + word.size()) {
+    return std::errc::invalid_argument;
+  }
+  return value;
+}
+
+template <typename T>
+std::string number_text(T value) {
+  std::array<char, 32> text{};
+  const auto result =
+      std::to_chars(text.data(), text.data() + text.size(), value);
+  return {text.data(), result.ptr};
+}
+
+outcome::result<ScriptedEvent> parse_event(std::string_view verb,
+                                           std::string_view& rest) {
+  if (verb == "click") {
+    ScriptedClick click;
+    click.x = OUTCOME_TRYX(next_number<float>(rest));
+    click.y = OUTCOME_TRYX(next_number<float>(rest));
+    return ScriptedEvent{click};
+  }
+  if (verb == "resize") {
+    ScriptedResize resize;
+    resize.width = OUTCOME_TRYX(next_number<unsigned>(rest));
+    resize.height = OUTCOME_TRYX(next_number<unsigned>(rest));
+    if (resize.width == 0 or resize.height == 0) {
+      return std::errc::argument_out_of_domain;
+    }
+    return ScriptedEvent{resize};
+  }
+  if (verb == "move") {
+    ScriptedMove move;
+    move.row = OUTCOME_TRYX(next_number<int>(rest));
+    move.col = OUTCOME_TRYX(next_number<int>(rest));
+    return ScriptedEvent{move};
+  }
+  if (verb == "undo") {
+    return ScriptedEvent{ScriptedUndo{}};
+  }
+  if (verb == "redo") {
+    return ScriptedEvent{ScriptedRedo{}};
+  }
+  return std::errc::invalid_argument;
+}
+
+}  // namespace
+
+std::string format_rules(const GameRules& rules) {
+  return "rules " + std::to_string(rules.rows) + ' ' +
+         std::to_string(rules.cols) + ' ' + std::to_string(rules.win_length);
+}
+
+std::string format_event(const ScriptedEvent& event) {
+  return std::visit(
+      [](const auto& e) -> std::string {
+        using T = std::decay_t<decltype(e)>;
+        if constexpr (std::is_same_v<T, ScriptedClick>) {
+          return "click " + number_text(e.x) + ' ' + number_text(e.y);
+        } else if constexpr (std::is_same_v<T, ScriptedResize>) {
+          return "resize " + std::to_string(e.width) + ' ' +
+                 std::to_string(e.height);
+        } else if constexpr (std::is_same_v<T, ScriptedMove>) {
+          return "move " + std::to_string(e.row) + ' ' +
+                 std::to_string(e.col);
+        } else if constexpr (std::is_same_v<T, ScriptedUndo>) {
+          return "undo";
+        } else {
+          return "redo";
+        }
+      },
+      event);
+}
+
+outcome::result<InputScript> parse_input_script(std::string_view text) {
+  InputScript script;
+  while (!text.empty()) {
+    const auto end = text.find('\n');
+    auto rest = text.substr(0, end);
+    text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+
+    const auto verb = next_word(rest);
+    if (verb.empty() or verb.front() == '#') {
+      continue;
+    }
+    if (verb == "rules") {
+      // only before the first event, and only once
+      if (script.rules or !script.events.empty()) {
+        return std::errc::invalid_argument;
+      }
+      GameRules rules;
+      rules.rows = OUTCOME_TRYX(next_number<int>(rest));
+      rules.cols = OUTCOME_TRYX(next_number<int>(rest));
+      rules.win_length = OUTCOME_TRYX(next_number<int>(rest));
+      script.rules = rules;
+    } else {
+      script.events.push_back(OUTCOME_TRYX(parse_event(verb, rest)));
+    }
+    if (!next_word(rest).empty()) {
+      return std::errc::invalid_argument;
+    }
+  }
+  return script;
+}
+
+outcome::result<InputScript> read_input_script(
+    const std::filesystem::path& path) {
+  std::FILE* file = std::fopen(path.string().c_str(), "rb");
+  if (file == nullptr) {
+    return std::errc::no_such_file_or_directory;
+  }
+  std::string text;
+  std::array<char, 4096> buffer{};
+  std::size_t read = 0;
+  while ((read = std::fread(buffer.data(), 1, buffer.size(), file)) > 0) {
+    text.append(buffer.data(), read);
+  }
+  const bool failed = std::ferror(file) != 0;
+  std::fclose(file);
+  if (failed) {
+    return std::errc::io_error;
+  }
+  return parse_input_script(text);
+}
+
+outcome::result<InputScriptWriter> InputScriptWriter::open(
+    const std::filesystem::path& path, const GameRules& rules) {
+  std::FILE* file = std::fopen(path.string().c_str(), "wb");
+  if (file == nullptr) {
+    return std::errc::io_error;
+  }
+  InputScriptWriter writer{file};
+  OUTCOME_TRYV(writer.write_line(format_rules(rules)));
+  return writer;
+}
+
+InputScriptWriter::InputScriptWriter(InputScriptWriter&& other) noexcept
+    : file_{std::exchange(other.file_, nullptr)} {}
+
+InputScriptWriter::~InputScriptWriter() {
+  if (file_ != nullptr) {
+    std::fclose(file_);
+  }
+}
+
+outcome::result<void> InputScriptWriter::append(const ScriptedEvent& event) {
+  return write_line(format_event(event));
+}
+
+outcome::result<void> InputScriptWriter::flush() {
+  if (std::fflush(file_) != 0) {
+    return std::errc::io_error;
+  }
+  return outcome::success();
+}
+
+outcome::result<void> InputScriptWriter::write_line(const std::string& line) {
+  if (std::fputs(line.c_str(), file_) == EOF or
+      std::fputc('\n', file_) == EOF) {
+    return std::errc::io_error;
+  }
+  return outcome::success();
+}
+
+InputScript synthetic_input_script(const GameRules& rules, float board_width,
+                                   float board_height, std::size_t count,
+                                   std::size_t resize_every,
+                                   std::uint32_t seed) {
+  std::mt19937 rng{seed};
+  std::uniform_real_distribution<float> x{0.0f, board_width};
+  std::uniform_real_distribution<float> y{0.0f, board_height};
+  std::uniform_int_distribution<unsigned> width{320, 1920};
+  std::uniform_int_distribution<unsigned> height{240, 1080};
+
+  InputScript script;
+  script.rules = rules;
+  script.events.reserve(count);
+  for (std::size_t i = 1; i <= count; ++i) {
+    if (resize_every != 0 and i % resize_every == 0) {
+      script.events.emplace_back(ScriptedResize{width(rng), height(rng)});
+    } else {
+      script.events.emplace_back(ScriptedClick{x(rng), y(rng)});
+    }
+  }
+  return script;
+}
+
+}  // namespace tictactoe
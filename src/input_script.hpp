@@ -0,0 +1,121 @@
+#ifndef TICTACTOE_INPUT_SCRIPT_H_
+#define TICTACTOE_INPUT_SCRIPT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <optional>
+#include <outcome.hpp>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "board.hpp"
+
+namespace tictactoe {
+
+// A click at a location in world coordinates, as passed to
+// Grid::handle_click, so it hits the same field whatever the window size,
+// zoom and pan were.
+struct ScriptedClick {
+  float x = 0.0f;
+  float y = 0.0f;
+
+  bool operator==(const ScriptedClick&) const = default;
+};
+
+// The window was resized to this many pixels.
+struct ScriptedResize {
+  unsigned width = 0;
+  unsigned height = 0;
+
+  bool operator==(const ScriptedResize&) const = default;
+};
+
+// A move that did not come from a click: the computer's, or one announced by
+// the game server.
+struct ScriptedMove {
+  int row = 0;
+  int col = 0;
+
+  bool operator==(const ScriptedMove&) const = default;
+};
+
+// The last move was taken back.
+struct ScriptedUndo {
+  bool operator==(const ScriptedUndo&) const = default;
+};
+
+// The last move taken back was made again.
+struct ScriptedRedo {
+  bool operator==(const ScriptedRedo&) const = default;
+};
+
+using ScriptedEvent = std::variant<ScriptedClick, ScriptedResize, ScriptedMove,
+                                   ScriptedUndo, ScriptedRedo>;
+
+// Window input and the moves it led to, recorded by the game
+// (--record-input) or generated for load testing, to be replayed without a
+// user. As text, one entry per line:
+//
+//   rules <rows> <cols> <win length>
+//   click <x> <y>
+//   resize <width> <height>
+//   move <row> <col>
+//   undo
+//   redo
+//
+// The optional rules line comes first; blank lines and lines starting with
+// '#' are skipped.
+struct InputScript {
+  std::optional<GameRules> rules;
+  std::vector<ScriptedEvent> events;
+};
+
+// The line for rules or an event, without the line break.
+std::string format_rules(const GameRules& rules);
+std::string format_event(const ScriptedEvent& event);
+
+outcome::result<InputScript> parse_input_script(std::string_view text);
+outcome::result<InputScript> read_input_script(
+    const std::filesystem::path& path);
+
+// Writes an input script as the events happen, e.g. while the game runs.
+// Lines are buffered; they reach the file on flush() and when the writer is
+// destroyed.
+class InputScriptWriter {
+ public:
+  // Replaces any file at path with a script for rules.
+  static outcome::result<InputScriptWriter> open(
+      const std::filesystem::path& path, const GameRules& rules);
+
+  InputScriptWriter(InputScriptWriter&& other) noexcept;
+  InputScriptWriter& operator=(InputScriptWriter&&) = delete;
+  InputScriptWriter(const InputScriptWriter&) = delete;
+  InputScriptWriter& operator=(const InputScriptWriter&) = delete;
+  ~InputScriptWriter();
+
+  outcome::result<void> append(const ScriptedEvent& event);
+  outcome::result<void> flush();
+
+ private:
+  explicit InputScriptWriter(std::FILE* file) : file_{file} {}
+
+  outcome::result<void> write_line(const std::string& line);
+
+  std::FILE* file_;
+};
+
+// count events for a game by rules: clicks spread uniformly over a board of
+// board_width x board_height world units, and every resize_every-th event
+// (none if 0) a resize to a random size between 320x240 and 1920x1080.
+InputScript synthetic_input_script(const GameRules& rules,
+                                   float board_width, float board_height,
+                                   std::size_t count, std::size_t resize_every,
+                                   std::uint32_t seed);
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_INPUT_SCRIPT_H_
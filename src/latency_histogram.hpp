@@ -0,0 +1,86 @@
+#ifndef TICTACTOE_LATENCY_HISTOGRAM_H_
+#define TICTACTOE_LATENCY_HISTOGRAM_H_
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace tictactoe {
+
+// Log-linear histogram of durations (or any non-negative counts): every
+// power of two is split into kSubBuckets equal buckets, so a percentile is
+// off by at most 1/kSubBuckets of its value. Recording is a single relaxed
+// atomic increment, so one thread can record while others read.
+class LatencyHistogram {
+ public:
+  static constexpr std::uint64_t kSubBuckets = 8;
+  static constexpr std::size_t kBuckets =
+      kSubBuckets + (64 - std::countr_zero(kSubBuckets)) * kSubBuckets;
+
+  static constexpr std::size_t bucket_of(std::uint64_t value) {
+    if (value < kSubBuckets) {
+      return value;
+    }
+    // value has at least as many bits as kSubBuckets
+    const std::uint64_t shift =
+        std::bit_width(value) - std::bit_width(kSubBuckets);
+    const std::uint64_t sub = (value >> shift) - kSubBuckets;
+    return kSubBuckets * (shift + 1) + sub;
+  }
+
+  // Smallest value that falls into the bucket.
+  static constexpr std::uint64_t lower_bound(std::size_t bucket) {
+    if (bucket < kSubBuckets) {
+      return bucket;
+    }
+    const auto shift = bucket / kSubBuckets - 1;
+    return (kSubBuckets + bucket % kSubBuckets) << shift;
+  }
+
+  void record(std::uint64_t value) {
+    counts_[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void add(const LatencyHistogram& other) {
+    for (std::size_t i = 0; i < kBuckets; ++i) {
+      counts_[i].fetch_add(other.counts_[i].load(std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+    }
+  }
+
+  std::uint64_t count() const {
+    std::uint64_t total = 0;
+    for (const auto& c : counts_) {
+      total += c.load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+  // Lower bound of the bucket holding the q-quantile, q in [0, 1]; 0 when
+  // nothing was recorded.
+  std::uint64_t percentile(double q) const {
+    const auto total = count();
+    if (total == 0) {
+      return 0;
+    }
+    const auto rank =
+        static_cast<std::uint64_t>(q * static_cast<double>(total - 1));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < kBuckets; ++i) {
+      seen += counts_[i].load(std::memory_order_relaxed);
+      if (seen > rank) {
+        return lower_bound(i);
+      }
+    }
+    return lower_bound(kBuckets - 1);
+  }
+
+ private:
+  std::array<std::atomic<std::uint64_t>, kBuckets> counts_{};
+};
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_LATENCY_HISTOGRAM_H_
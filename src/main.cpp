@@ -1,496 +1,607 @@
-#include <docopt/docopt.h>
 #include <imgui-SFML.h>
 #include <imgui.h>
+#include <spdlog/async.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
 
 #include <SFML/Graphics.hpp>
 #include <SFML/System/Clock.hpp>
 #include <SFML/Window/Event.hpp>
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
 #include <filesystem>
-#include <functional>
+#include <memory>
+#include <numeric>
 #include <optional>
 #include <outcome.hpp>
+#include <string>
 #include <system_error>
-#include <tuple>
+#include <variant>
 #include <vector>
 namespace fs = std::filesystem;
 
-#include "solarized.hpp"
+#include "camera.hpp"
+#include "configuration.hpp"
+#include "engine.hpp"
+#include "grid.hpp"
+#include "input_script.hpp"
+#include "mcts_player.hpp"
+#include "metrics.hpp"
+#include "negamax_player.hpp"
+#include "opening_book.hpp"
 
-namespace outcome = OUTCOME_V2_NAMESPACE;
+#if defined(TICTACTOE_HAS_NETWORK)
+#include "game_client.hpp"
+#endif
 
-template <typename T>
-auto EqualTo(const T& val) {
-  return [&val](const auto& x) { return x == val; };
-}
+namespace outcome = OUTCOME_V2_NAMESPACE;
 
 namespace tictactoe {
 
-struct Configuration {
-  fs::path asset_dir;
-};
-
-outcome::result<fs::path> MakeAssetDir(const fs::path& start_dir,
-                                       const fs::path& work_dir) {
-  fs::path assets = start_dir.is_absolute() ? start_dir : work_dir / start_dir;
-
-  assets.remove_filename();
-  assets /= "../assets";
-
-  return assets;
-}
-
-outcome::result<Configuration> MakeConfiguration(
-    const std::vector<std::string>& commandline_args,
-    const fs::path& work_dir) {
-  Configuration config;
-  config.asset_dir =
-      OUTCOME_TRYX(MakeAssetDir(fs::path{commandline_args[0]}, work_dir));
-  return config;
+std::string FormatSearchStatistics(const SearchStatistics& stats) {
+  return fmt::format(
+      "ai: depth {}{} score {} nodes {} ({:.0f} nodes/s) tt hit rate {:.1f}%",
+      stats.completed_depth,
+      stats.from_book ? " (book)" : stats.solved ? " (solved)" : "",
+      stats.score,
+      stats.nodes, stats.nodes_per_second(), stats.tt_hit_rate() * 100.0);
 }
 
-std::size_t pos2idx(int row, int column, int grid_size) {
-  return static_cast<std::size_t>(column + row * grid_size);
+std::string FormatSearchStatistics(const MctsStatistics& stats) {
+  return fmt::format(
+      "ai: {} playouts ({:.0f} playouts/s, {} threads) reused {} nodes {} "
+      "win rate {:.1f}%",
+      stats.playouts, stats.playouts_per_second(), stats.threads,
+      stats.reused_playouts, stats.tree_nodes, stats.win_rate * 100.0);
 }
 
-std::tuple<int, int> idx2pos(std::size_t index, int grid_size) {
-  const auto x = static_cast<int>(index) % grid_size;
-  const auto y = static_cast<int>(index) / grid_size;
-  return std::make_tuple(x, y);
+// One line per timing for the debug overlay, in microseconds.
+std::vector<std::string> FormatTimings(const metrics::Registry& registry) {
+  const auto micros = [](std::chrono::nanoseconds ns) {
+    return std::chrono::duration<double, std::micro>(ns).count();
+  };
+  std::vector<std::string> lines;
+  for (const auto& t : registry.timing_summaries()) {
+    lines.push_back(fmt::format("{}: {} calls, p50 {:.1f} us, p99 {:.1f} us",
+                                t.name, t.count, micros(t.p50),
+                                micros(t.p99)));
+  }
+  return lines;
 }
 
-enum class Player {
-  CirclePlayer,
-  CrossPlayer,
-};
+using ComputerPlayer = std::variant<NegamaxPlayer, MctsPlayer>;
 
-enum class FieldState {
-  Empty,
-  Circle,
-  Cross,
-};
-
-class Engine;
-
-class Position {
-  int row_;
-  int col_;
-
-  Position(int row, int col) : row_{row}, col_{col} {}
+std::string FormatSearchStatistics(const ComputerPlayer& ai) {
+  return std::visit(
+      [](const auto& player) {
+        return FormatSearchStatistics(player.last_search_statistics());
+      },
+      ai);
+}
 
- public:
-  static outcome::result<Position> create_position_for_engine(
-      std::tuple<int, int> p, const Engine& e) {
-    return create_position_for_engine(std::get<0>(p), std::get<1>(p), e);
+outcome::result<void> PlayComputerMove(Engine& engine, Grid& grid,
+                                       ComputerPlayer& ai, Player ai_side) {
+  if (engine.maybe_winner() or engine.get_active_player() != ai_side) {
+    return outcome::success();
   }
-  static outcome::result<Position> create_position_for_engine(
-      int row, int col, const Engine& engine);
-
-  int row() const { return row_; }
-  int col() const { return col_; }
-};
-
-class Engine {
-  using BoardData = std::vector<FieldState>;
-  BoardData fields_;
-  int board_size_;
-  Player active_player_ = Player::CrossPlayer;
-  std::optional<Player> winner_ = std::nullopt;
 
-  Engine(int board_size)
-      : fields_(static_cast<BoardData::size_type>(board_size * board_size),
-                FieldState::Empty),
-        board_size_{board_size} {}
-
- public:
-  static outcome::result<Engine> create_engine(int board_size) {
-    if (board_size <= 1) {
-      return std::errc::argument_out_of_domain;
+  auto move = std::visit(
+      [&](auto& player) { return player.choose_move(engine); }, ai);
+  if (!move) {
+    // no empty field left, the game ended in a draw
+    if (move.error() == std::errc::operation_not_permitted) {
+      return outcome::success();
     }
-    return Engine(board_size);
+    return move.error();
   }
 
-  std::optional<Player> maybe_winner_for_row(int row_id) {
-    if (row_id < 0 or row_id >= board_size_) {
-      return std::nullopt;
-    }
-
-    const auto row_begin = std::next(fields_.begin(), row_id * board_size_);
-    const auto row_end = std::next(fields_.begin(), (row_id + 1) * board_size_);
+  spdlog::info("{}", FormatSearchStatistics(ai));
+  OUTCOME_TRYV(engine.handle_field_selected(move.value()));
+  grid.update_field(move.value());
+  return outcome::success();
+}
 
-    if (std::all_of(row_begin, row_end, EqualTo(FieldState::Circle))) {
-      return Player::CirclePlayer;
-    }
-    if (std::all_of(row_begin, row_end, EqualTo(FieldState::Cross))) {
-      return Player::CrossPlayer;
+// Takes back moves until it is a human's turn again: one move, or the
+// computer's reply together with the move before it.
+outcome::result<void> UndoTurn(Engine& engine, Grid& grid,
+                               std::optional<Player> ai_side) {
+  do {
+    if (!engine.can_undo()) {
+      return std::errc::operation_not_permitted;
     }
+    const auto pos = engine.position_of(engine.move_history().back());
+    OUTCOME_TRYV(engine.undo());
+    grid.update_field(pos);
+  } while (ai_side and engine.get_active_player() == *ai_side and
+           engine.can_undo());
+  return outcome::success();
+}
 
-    return std::nullopt;
-  }
-
-  std::optional<Player> maybe_winner_for_column(int col_id) {
-    if (col_id < 0 or col_id >= board_size_) {
-      return std::nullopt;
-    }
+outcome::result<void> RedoTurn(Engine& engine, Grid& grid,
+                               std::optional<Player> ai_side) {
+  do {
+    OUTCOME_TRYV(engine.redo());
+    grid.update_field(engine.position_of(engine.move_history().back()));
+  } while (ai_side and engine.get_active_player() == *ai_side and
+           engine.can_redo());
+  return outcome::success();
+}
 
-    bool all_eq = true;
-    for (int i = 1; i < board_size_; ++i) {
-      if (fields_[static_cast<BoardData::size_type>(col_id)] !=
-          fields_[static_cast<BoardData::size_type>(col_id +
-                                                    i * board_size_)]) {
-        all_eq = false;
-        break;
-      }
+#if defined(TICTACTOE_HAS_NETWORK)
+// A game hosted by a game server. Clicks are sent there as moves, and moves
+// only reach the local engine once the server announces them, so both
+// players always see the same board.
+class RemoteGame {
+ public:
+  static outcome::result<RemoteGame> connect(const Configuration& config) {
+    const auto& server = *config.server;
+    auto client = OUTCOME_TRYX(GameClient::connect(server.host, server.port));
+    if (config.join_game) {
+      OUTCOME_TRYV(client.send(protocol::JoinGame{*config.join_game}));
+    } else {
+      OUTCOME_TRYV(client.send(protocol::NewGame{config.rules}));
     }
 
-    if (!all_eq) {
-      return std::nullopt;
+    const auto reply =
+        OUTCOME_TRYX(client.wait(std::chrono::milliseconds{5000}));
+    if (const auto* error = std::get_if<protocol::Error>(&reply)) {
+      spdlog::error("server refused the game: {}", error->reason);
+      return std::errc::connection_refused;
     }
-
-    switch (fields_[static_cast<BoardData::size_type>(col_id)]) {
-      case FieldState::Circle:
-        return Player::CirclePlayer;
-      case FieldState::Cross:
-        return Player::CrossPlayer;
-      default:
-        return std::nullopt;
+    const auto* joined = std::get_if<protocol::GameJoined>(&reply);
+    if (!joined) {
+      return std::errc::bad_message;
     }
+    spdlog::info("playing game {} on {}:{} as {}", joined->game, server.host,
+                 server.port, SeatName(joined->seat));
+    return RemoteGame{std::move(client), *joined};
   }
 
-  std::optional<Player> maybe_get_winner_for_diagonal() {
-    bool all_eq = true;
-    for (int i = 1; i < board_size_; ++i) {
-      if (fields_[pos2idx(0, 0, board_size_)] !=
-          fields_[pos2idx(i, i, board_size_)]) {
-        all_eq = false;
-        break;
-      }
-    }
-    if (!all_eq) {
-      return std::nullopt;
-    }
+  const GameRules& rules() const { return joined_.rules; }
 
-    switch (fields_[pos2idx(0, 0, board_size_)]) {
-      case FieldState::Circle:
-        return Player::CirclePlayer;
-      case FieldState::Cross:
-        return Player::CrossPlayer;
-      default:
-        return std::nullopt;
-    }
+  std::string summary() const {
+    return fmt::format("online game {} as {}", joined_.game,
+                       SeatName(joined_.seat));
   }
 
-  std::optional<Player> maybe_get_winner_for_antidiagonal() {
-    bool all_eq = true;
-    auto last_idx = board_size_ - 1;
-    for (int i = 1; i < board_size_; ++i) {
-      if (fields_[pos2idx(0, last_idx, board_size_)] !=
-          fields_[pos2idx(i, last_idx - i, board_size_)]) {
-        all_eq = false;
-        break;
-      }
-    }
-    if (!all_eq) {
-      return std::nullopt;
-    }
-
-    switch (fields_[pos2idx(0, last_idx, board_size_)]) {
-      case FieldState::Circle:
-        return Player::CirclePlayer;
-      case FieldState::Cross:
-        return Player::CrossPlayer;
-      default:
-        return std::nullopt;
-    }
+  outcome::result<void> send_move(const Position& pos) {
+    return client_.send(protocol::MakeMove{joined_.game, pos.row(), pos.col()});
   }
 
-  Player get_active_player() { return active_player_; }
-
-  std::optional<Player> maybe_get_winner() {
-    for (int i = 0; i < board_size_; ++i) {
-      auto player_opt = maybe_winner_for_row(i);
-      if (player_opt) {
-        return player_opt;
-      }
-    }
-
-    for (int i = 0; i < board_size_; ++i) {
-      auto player_opt = maybe_winner_for_column(i);
-      if (player_opt) {
-        return player_opt;
+  // Plays the moves the server announced since the last call. Returns
+  // whether anything changed.
+  outcome::result<bool> sync(Engine& engine, Grid& grid) {
+    bool changed = false;
+    for (const auto& reply : OUTCOME_TRYX(client_.poll())) {
+      if (const auto* move = std::get_if<protocol::MoveMade>(&reply)) {
+        const auto pos = OUTCOME_TRYX(
+            Position::create_position_for_engine(move->row, move->col, engine));
+        OUTCOME_TRYV(engine.handle_field_selected(pos));
+        grid.update_field(pos);
+        changed = true;
+      } else if (const auto* seat = std::get_if<protocol::GameJoined>(&reply)) {
+        joined_.seat = seat->seat;
+        spdlog::info("an opponent joined, playing as {}", SeatName(seat->seat));
+        changed = true;
+      } else if (std::holds_alternative<protocol::GameLeft>(reply)) {
+        spdlog::info("the opponent left the game");
+      } else if (const auto* error = std::get_if<protocol::Error>(&reply)) {
+        spdlog::warn("server: {}", error->reason);
       }
     }
-
-    auto player_opt = maybe_get_winner_for_diagonal();
-    if (player_opt) {
-      return player_opt;
-    }
-
-    player_opt = maybe_get_winner_for_antidiagonal();
-    if (player_opt) {
-      return player_opt;
-    }
-
-    return std::nullopt;
+    return changed;
   }
 
-  int board_size() const { return board_size_; }
-  std::optional<Player> maybe_winner() const { return winner_; }
-
-  FieldState get_field_state_at(const Position& pos) {
-    return fields_.at(pos2idx(pos.row(), pos.col(), board_size_));
-  }
-
-  Player next_player() {
-    switch (active_player_) {
-      case Player::CrossPlayer:
-        return Player::CirclePlayer;
-      case Player::CirclePlayer:
-      default:
-        return Player::CrossPlayer;
+ private:
+  RemoteGame(GameClient client, const protocol::GameJoined& joined)
+      : client_{std::move(client)}, joined_{joined} {}
+
+  static const char* SeatName(Seat seat) {
+    switch (seat) {
+      case Seat::Cross:
+        return "cross";
+      case Seat::Circle:
+        return "circle";
+      case Seat::Both:
+        return "both sides";
     }
+    return "both sides";
   }
 
-  outcome::result<void> update_field_state_at(const Position& pos,
-                                              FieldState state) {
-    if (state == FieldState::Empty) {
-      return std::errc::argument_out_of_domain;
-    }
-    fields_.at(pos2idx(pos.row(), pos.col(), board_size_)) = state;
-    return outcome::success();
+  GameClient client_;
+  protocol::GameJoined joined_;
+};
+#else
+// Stands in for the networked game on platforms without sockets.
+class RemoteGame {
+ public:
+  static outcome::result<RemoteGame> connect(const Configuration&) {
+    spdlog::error("this build cannot connect to a game server");
+    return std::errc::not_supported;
   }
+  const GameRules& rules() const { return rules_; }
+  std::string summary() const { return {}; }
+  outcome::result<void> send_move(const Position&) {
+    return std::errc::not_supported;
+  }
+  outcome::result<bool> sync(Engine&, Grid&) { return false; }
 
-  outcome::result<void> handle_field_selected(const Position& pos) {
-    if (winner_) {
-      return outcome::success();
-    }
+ private:
+  GameRules rules_;
+};
+#endif
 
-    FieldState state = get_field_state_at(pos);
-    if (state != FieldState::Empty) {
-      return outcome::failure(std::errc::invalid_argument);
-    }
+// Rolling window of the most recent frame times for the debug overlay. A
+// frame's time ends with its last draw call, so the wait for the frame rate
+// limit in display() does not hide what drawing costs.
+class FrameTimes {
+ public:
+  static constexpr int kFrames = 120;
 
-    FieldState new_state = active_player_ == Player::CrossPlayer
-                               ? FieldState::Cross
-                               : FieldState::Circle;
-    OUTCOME_TRYV(update_field_state_at(pos, new_state));
+  void record(sf::Time frame) {
+    samples_ms_[static_cast<std::size_t>(next_)] = frame.asSeconds() * 1000.0f;
+    next_ = (next_ + 1) % kFrames;
+    count_ = std::min(count_ + 1, kFrames);
+  }
 
-    active_player_ = next_player();
-    winner_ = maybe_get_winner();
+  std::string summary() const {
+    const auto begin = samples_ms_.begin();
+    const auto end = begin + count_;
+    const float total = std::accumulate(begin, end, 0.0f);
+    const float average =
+        count_ > 0 ? total / static_cast<float>(count_) : 0.0f;
+    const float worst = count_ > 0 ? *std::max_element(begin, end) : 0.0f;
+    return fmt::format("frame time: avg {:.2f} ms, max {:.2f} ms ({:.0f} fps)",
+                       average, worst,
+                       average > 0.0f ? 1000.0f / average : 0.0f);
+  }
 
-    return outcome::success();
+  void plot() const {
+    ImGui::PlotLines("frame ms", samples_ms_.data(), count_,
+                     count_ < kFrames ? 0 : next_);
   }
+
+ private:
+  std::array<float, kFrames> samples_ms_{};
+  int next_ = 0;
+  int count_ = 0;
 };
 
-outcome::result<Position> Position::create_position_for_engine(
-    int row, int col, const Engine& engine) {
-  if (row < 0 or row >= engine.board_size()) {
-    return std::errc::argument_out_of_domain;
-  }
-  if (col < 0 or col >= engine.board_size()) {
-    return std::errc::argument_out_of_domain;
-  }
+outcome::result<void> Main(const std::vector<std::string>& args) {
+  spdlog::info("Hello, {}!", "World");
 
-  return Position(row, col);
-}
+  // startup milestones are logged relative to this
+  const sf::Clock startup_clock;
+  const auto log_startup = [&](const char* milestone) {
+    spdlog::info("startup: {} after {} ms", milestone,
+                 startup_clock.getElapsedTime().asMilliseconds());
+  };
 
-class Grid {
-  Engine& engine_;
-  int num_boxes_side_;
-  int num_boxes_total_;
-  std::vector<sf::FloatRect> field_bounds_;
-  std::vector<sf::RectangleShape> fields_;
+  const tictactoe::Configuration config =
+      OUTCOME_TRYX(tictactoe::MakeConfiguration(args, fs::current_path()));
 
-  constexpr static float side_size = 10.0f;
-  constexpr static float offset_factor = 0.1f;
-  constexpr static float offset = side_size * offset_factor;
-  constexpr static float spacing = side_size + offset;
+  auto& registry = metrics::Registry::global();
+  registry.set_enabled(true);
+  auto& event_timing = registry.timing("tictactoe_event_handling_seconds",
+                                       "Time handling one window event takes");
+  auto& frame_timing = registry.timing(
+      "tictactoe_frame_seconds",
+      "Time one event loop iteration takes up to the end of drawing, without "
+      "waiting for events or the frame rate limit");
+  auto& display_timing = registry.timing(
+      "tictactoe_display_seconds",
+      "Time presenting a frame takes, including the wait for the frame rate "
+      "limit");
+  auto& events_handled =
+      registry.counter("tictactoe_events_total", "Window events handled");
+  auto& frames_drawn =
+      registry.counter("tictactoe_frames_total", "Frames drawn");
+  const auto write_metrics = [&] {
+    if (!config.metrics_file) {
+      return;
+    }
+    auto written = registry.write_prometheus(*config.metrics_file);
+    if (!written) {
+      spdlog::warn("writing the metrics to {} failed with: {}",
+                   config.metrics_file->string(), written.error().message());
+    }
+  };
 
-  sf::Image crossImage;
-  sf::Image circleImage;
-  sf::Texture crossTexture;
-  sf::Texture circleTexture;
+  sf::RenderWindow window(sf::VideoMode(1024, 768), "ImGui + SFML = <3");
+  window.setFramerateLimit(60);
+  ImGui::SFML::Init(window);
+  log_startup("window opened");
 
- public:
-  Grid(const Configuration& config, Engine& engine)
-      : engine_{engine},
-        num_boxes_side_{engine.board_size()},
-        num_boxes_total_{num_boxes_side_ * num_boxes_side_} {
-    field_bounds_.reserve(static_cast<std::size_t>(num_boxes_total_));
-    fields_.reserve(static_cast<std::size_t>(num_boxes_total_));
+  constexpr auto scale_factor = 2.0;
+  ImGui::GetStyle().ScaleAllSizes(scale_factor);
+  ImGui::GetIO().FontGlobalScale = scale_factor;
 
-    auto result = update_grid();
-    if (!result) {
-      spdlog::error("initial grid update failed: {}", result.error().message());
+  std::optional<RemoteGame> remote;
+  if (config.server) {
+    remote.emplace(OUTCOME_TRYX(RemoteGame::connect(config)));
+    if (config.ai_player) {
+      spdlog::warn("--ai is ignored when playing on a server");
     }
+  }
 
-    spdlog::info("current working dir is {}", fs::current_path().string());
+  const auto& rules = remote ? remote->rules() : config.rules;
+  tictactoe::Engine board =
+      OUTCOME_TRYX(tictactoe::Engine::create_engine(rules));
+  tictactoe::Grid g{config, board};
 
-    crossImage.loadFromFile((config.asset_dir / "cross.png").string());
-    circleImage.loadFromFile((config.asset_dir / "circle.png").string());
-    crossTexture.loadFromImage(crossImage);
-    circleTexture.loadFromImage(circleImage);
+  std::optional<InputScriptWriter> input_record;
+  if (config.input_record_file) {
+    input_record.emplace(OUTCOME_TRYX(
+        InputScriptWriter::open(*config.input_record_file, rules)));
   }
+  const auto record_input = [&](const ScriptedEvent& event) {
+    if (!input_record) {
+      return;
+    }
+    auto written = input_record->append(event);
+    if (!written) {
+      spdlog::warn("recording the input failed with: {}, stopped recording",
+                   written.error().message());
+      input_record.reset();
+    }
+  };
+  // events are buffered, so writing them never waits for the disk
+  const auto flush_input_record = [&] {
+    if (!input_record) {
+      return;
+    }
+    auto flushed = input_record->flush();
+    if (!flushed) {
+      spdlog::warn("recording the input failed with: {}, stopped recording",
+                   flushed.error().message());
+      input_record.reset();
+    }
+  };
+  record_input(ScriptedResize{window.getSize().x, window.getSize().y});
+  // Clicks are recorded as they happen; moves that came from elsewhere are
+  // recorded once made, so a replay does not depend on the computer's search
+  // or the server.
+  const auto record_moves_since = [&](std::size_t before) {
+    const auto& played = board.move_history();
+    for (auto i = before; i < played.size(); ++i) {
+      const auto pos = board.position_of(played[i]);
+      record_input(ScriptedMove{pos.row(), pos.col()});
+    }
+  };
+
+  std::optional<ComputerPlayer> ai;
+  if (remote) {
+    // both players are behind the server
+  } else if (config.ai_player and config.ai_engine == AiEngine::Mcts) {
+    MctsLimits limits;
+    limits.playouts = config.ai_playouts;
+    limits.time_budget = config.ai_time_budget;
+    limits.threads = config.ai_threads;
+    ai.emplace(std::in_place_type<MctsPlayer>, config.rules, limits);
+  } else if (config.ai_player) {
+    auto& negamax = std::get<NegamaxPlayer>(
+        ai.emplace(std::in_place_type<NegamaxPlayer>, config.rules,
+                   SearchLimits{config.ai_time_budget, 0}));
+    // mapped, not read: pages are only loaded as positions are probed
+    const auto book_path =
+        config.asset_dir / OpeningBook::file_name(config.rules);
+    if (auto book = OpeningBook::open(book_path)) {
+      spdlog::info("opening book {} with {} positions", book_path.string(),
+                   book.value().size());
+      negamax.set_opening_book(
+          std::make_shared<const OpeningBook>(std::move(book).value()));
+    } else {
+      spdlog::info("no opening book at {}", book_path.string());
+    }
+  }
+  const auto play_computer_move = [&]() -> outcome::result<void> {
+    if (!ai) {
+      return outcome::success();
+    }
+    const auto before = board.move_history().size();
+    OUTCOME_TRYV(PlayComputerMove(board, g, *ai, *config.ai_player));
+    record_moves_since(before);
+    return outcome::success();
+  };
+  OUTCOME_TRYV(play_computer_move());
+
+  // Zooming in stops with this many fields along the shorter side.
+  constexpr int kMinVisibleFields = 3;
+  Camera camera{g.get_board_size(), GridLayout::extent(kMinVisibleFields)};
+  sf::FloatRect viewport = tictactoe::ComputeAspectPreservingViewport(
+      window.getSize(), g.get_board_size());
+  window.setView(camera.view(viewport));
+  // Pixel the mouse was at while dragging the board with the right or middle
+  // button.
+  std::optional<sf::Vector2i> pan_from;
 
-  outcome::result<void> update_grid() {
-    for (int i = 0; i < num_boxes_side_; ++i) {
-      for (int j = 0; j < num_boxes_side_; ++j) {
-        const auto rect_size = sf::Vector2f{side_size, side_size};
-        sf::RectangleShape rect{rect_size};
+  bool show_overlay = false;
 
-        const float shift_x = offset + spacing * static_cast<float>(i);
-        const float shift_y = offset + spacing * static_cast<float>(j);
-        const auto position = sf::Vector2f{shift_x, shift_y};
+  // In on-demand mode frames are only drawn while this is non-zero. The
+  // overlay gets a second frame so ImGui can settle hover and active states.
+  int frames_to_draw = 1;
+  const auto request_redraw = [&] { frames_to_draw = show_overlay ? 2 : 1; };
 
-        rect.setPosition(position);
-        rect.setFillColor(sf::Color::Red);
-        auto pos =
-            OUTCOME_TRYX(Position::create_position_for_engine(j, i, engine_));
-        set_color_for_state(rect, engine_.get_field_state_at(pos));
+  const auto handle_event = [&](const sf::Event& event) {
+    const metrics::ScopedTimer timer{event_timing};
+    events_handled.add();
 
-        fields_.emplace_back(std::move(rect));
-        field_bounds_.emplace_back(position, rect_size);
-      }
+    if (show_overlay) {
+      ImGui::SFML::ProcessEvent(event);
+      request_redraw();
     }
 
-    return outcome::success();
-  }
-
-  void draw_on(sf::RenderWindow& window) {
-    const float bgnd_size =
-        offset + spacing * static_cast<float>(num_boxes_side_);
-    sf::RectangleShape background{sf::Vector2f{bgnd_size, bgnd_size}};
-    background.setPosition(0.0f, 0.0f);
-    background.setFillColor(Solarized::base3);
-
-    if (auto w = engine_.maybe_winner()) {
-      switch (*w) {
-        case Player::CrossPlayer:
-          background.setFillColor(Solarized::magenta);
-          break;
-        case Player::CirclePlayer:
-          background.setFillColor(Solarized::green);
-          break;
-      }
+    if (event.type == sf::Event::Closed) {
+      window.close();
     }
-    window.draw(background);
 
-    for (const auto& rect : fields_) {
-      window.draw(rect);
+    if (event.type == sf::Event::GainedFocus) {
+      request_redraw();
     }
-  }
 
-  void set_color_for_state(sf::RectangleShape& s, FieldState state) {
-    switch (state) {
-      case FieldState::Empty:
-        s.setFillColor(Solarized::base3);
-        return;
-      case FieldState::Circle:
-        s.setFillColor(Solarized::base00);
-        s.setTexture(&circleTexture);
-        return;
-      case FieldState::Cross:
-        s.setFillColor(Solarized::base00);
-        s.setTexture(&crossTexture);
-        return;
+    if (event.type == sf::Event::KeyPressed and
+        event.key.code == sf::Keyboard::F1) {
+      show_overlay = !show_overlay;
+      request_redraw();
     }
-  }
 
-  outcome::result<void> handle_click(const sf::Vector2f& location) {
-    auto it = std::find_if(fields_.begin(), fields_.end(),
-                           [&](const sf::RectangleShape& r) {
-                             return r.getGlobalBounds().contains(location);
-                           });
-    if (it != fields_.end()) {
-      const auto begin = fields_.begin();
-      const std::size_t idx =
-          static_cast<std::size_t>(std::distance(begin, it));
-      auto pos = OUTCOME_TRYX(Position::create_position_for_engine(
-          idx2pos(idx, num_boxes_side_), engine_));
-
-      OUTCOME_TRYV(engine_.handle_field_selected(pos));
-      OUTCOME_TRYV(update_grid());
+    // Ctrl+Z undoes a turn, Ctrl+Y or Ctrl+Shift+Z redoes it; the server
+    // has no undo
+    if (event.type == sf::Event::KeyPressed and event.key.control and
+        (event.key.code == sf::Keyboard::Z or
+         event.key.code == sf::Keyboard::Y) and
+        !remote) {
+      const bool redo =
+          event.key.code == sf::Keyboard::Y or event.key.shift;
+      const auto before = board.move_history().size();
+      auto result = redo ? RedoTurn(board, g, config.ai_player)
+                         : UndoTurn(board, g, config.ai_player);
+      if (!result) {
+        spdlog::info("nothing to {}", redo ? "redo" : "undo");
+      }
+      // a turn may be more than one move
+      for (auto i = board.move_history().size(); i < before; ++i) {
+        record_input(ScriptedUndo{});
+      }
+      for (auto i = before; i < board.move_history().size(); ++i) {
+        record_input(ScriptedRedo{});
+      }
+      // undoing the computer's opening move hands the turn back to it
+      auto ai_result = play_computer_move();
+      if (!ai_result) {
+        spdlog::warn("computer move failed with: {}",
+                     ai_result.error().message());
+      }
+      request_redraw();
     }
-    return outcome::success();
-  }
-
-  sf::View get_view() const {
-    sf::View v;
-    const float num_boxes_f = static_cast<float>(num_boxes_side_);
-    const float side_len = offset + spacing * (num_boxes_f);
-    const float center_pos = side_len * 0.5f;
-    v.setSize(side_len, side_len);
-    v.setCenter(center_pos, center_pos);
-    return v;
-  }
-};
-
-sf::FloatRect ComputeAspectPreservingViewport(const sf::Vector2u& screen_size) {
-  if (screen_size.x >= screen_size.y) {
-    const float dim_ratio_inv =
-        static_cast<float>(screen_size.y) / static_cast<float>(screen_size.x);
-    const float left_margin = (1.0f - dim_ratio_inv) * 0.5f;
-    return sf::FloatRect{left_margin, 0.0f, dim_ratio_inv, 1.0f};
-  }
 
-  const float dim_ratio_inv =
-      static_cast<float>(screen_size.x) / static_cast<float>(screen_size.y);
-  const float top_margin = (1.0f - dim_ratio_inv) * 0.5f;
-  return sf::FloatRect{0.0f, top_margin, 1.0f, dim_ratio_inv};
-}
-
-outcome::result<void> Main(const std::vector<std::string>& args) {
-  // Use the default logger (stdout, multi-threaded, colored)
-  spdlog::info("Hello, {}!", "World");
-
-  const tictactoe::Configuration config =
-      OUTCOME_TRYX(tictactoe::MakeConfiguration(args, fs::current_path()));
+    // catch the resize events
+    if (event.type == sf::Event::Resized) {
+      viewport = tictactoe::ComputeAspectPreservingViewport(
+          window.getSize(), g.get_board_size());
+      window.setView(camera.view(viewport));
+      record_input(ScriptedResize{window.getSize().x, window.getSize().y});
+      request_redraw();
+    }
 
-  sf::RenderWindow window(sf::VideoMode(1024, 768), "ImGui + SFML = <3");
-  window.setFramerateLimit(60);
-  ImGui::SFML::Init(window);
+    // the wheel zooms at the mouse cursor, Home shows the whole board again
+    if (event.type == sf::Event::MouseWheelScrolled) {
+      constexpr float kZoomPerNotch = 1.25f;
+      const auto anchor = window.mapPixelToCoords(
+          sf::Vector2i{event.mouseWheelScroll.x, event.mouseWheelScroll.y});
+      camera.zoom_at(anchor,
+                     std::pow(kZoomPerNotch, event.mouseWheelScroll.delta));
+      window.setView(camera.view(viewport));
+      request_redraw();
+    }
+    if (event.type == sf::Event::KeyPressed and
+        event.key.code == sf::Keyboard::Home) {
+      camera.reset();
+      window.setView(camera.view(viewport));
+      request_redraw();
+    }
 
-  constexpr auto scale_factor = 2.0;
-  ImGui::GetStyle().ScaleAllSizes(scale_factor);
-  ImGui::GetIO().FontGlobalScale = scale_factor;
+    const bool pan_button =
+        (event.type == sf::Event::MouseButtonPressed or
+         event.type == sf::Event::MouseButtonReleased) and
+        event.mouseButton.button != sf::Mouse::Left;
+    if (pan_button) {
+      pan_from = event.type == sf::Event::MouseButtonPressed
+                     ? std::optional{sf::Vector2i{event.mouseButton.x,
+                                                  event.mouseButton.y}}
+                     : std::nullopt;
+      return;
+    }
+    if (event.type == sf::Event::MouseMoved and pan_from) {
+      const sf::Vector2i to{event.mouseMove.x, event.mouseMove.y};
+      camera.pan(window.mapPixelToCoords(*pan_from) -
+                 window.mapPixelToCoords(to));
+      pan_from = to;
+      window.setView(camera.view(viewport));
+      request_redraw();
+    }
 
-  tictactoe::Engine board = OUTCOME_TRYX(tictactoe::Engine::create_engine(3));
-  tictactoe::Grid g{config, board};
+    if (event.type == sf::Event::MouseButtonReleased and remote) {
+      const sf::Vector2f mouse_pos_world =
+          window.mapPixelToCoords(sf::Mouse::getPosition(window));
+      // the board only changes once the server confirms the move
+      if (const auto pos = g.field_at(mouse_pos_world)) {
+        auto result = remote->send_move(*pos);
+        if (!result) {
+          spdlog::warn("sending the move failed with: {}",
+                       result.error().message());
+        }
+      }
+    } else if (event.type == sf::Event::MouseButtonReleased) {
+      const sf::Vector2f mouse_pos_world =
+          window.mapPixelToCoords(sf::Mouse::getPosition(window));
+      record_input(ScriptedClick{mouse_pos_world.x, mouse_pos_world.y});
+      auto result = g.handle_click(mouse_pos_world);
+      if (!result) {
+        spdlog::warn("click failed with: {}", result.error().message());
+      }
+      spdlog::info("click at ({}, {})", mouse_pos_world.x, mouse_pos_world.y);
 
-  sf::FloatRect viewport_debug{};
+      auto ai_result = play_computer_move();
+      if (!ai_result) {
+        spdlog::warn("computer move failed with: {}",
+                     ai_result.error().message());
+      }
+      request_redraw();
+    }
+  };
 
-  bool show_overlay = false;
+  // waiting for window events would leave server messages unread
+  const bool on_demand =
+      config.render_mode == RenderMode::OnDemand and !remote;
+  log_startup("ready for input");
+  bool first_frame = true;
 
   sf::Clock deltaClock;
+  sf::Clock frameClock;
+  FrameTimes frame_times;
+  const sf::Time metrics_interval = sf::seconds(10.0f);
+  sf::Clock metricsClock;
   while (window.isOpen()) {
     sf::Event event{};
+    if (on_demand and frames_to_draw == 0 and !g.assets_loading() and
+        window.waitEvent(event)) {
+      handle_event(event);
+    }
+    // excludes the time spent idle in waitEvent
+    frameClock.restart();
+
     while (window.pollEvent(event)) {
-      if (show_overlay) ImGui::SFML::ProcessEvent(event);
+      handle_event(event);
+    }
 
-      if (event.type == sf::Event::Closed) {
+    if (remote) {
+      const auto before = board.move_history().size();
+      auto synced = remote->sync(board, g);
+      record_moves_since(before);
+      if (!synced) {
+        spdlog::error("lost the game server: {}", synced.error().message());
         window.close();
+        continue;
       }
+    }
 
-      // catch the resize events
-      if (event.type == sf::Event::Resized) {
-        auto viewport =
-            tictactoe::ComputeAspectPreservingViewport(window.getSize());
-        viewport_debug = viewport;
-        auto view = g.get_view();
-        view.setViewport(viewport);
-        window.setView(view);
-      }
+    if (g.update_assets()) {
+      log_startup("textures ready");
+      request_redraw();
+    }
 
-      if (event.type == sf::Event::MouseButtonReleased) {
-        const sf::Vector2f mouse_pos_world =
-            window.mapPixelToCoords(sf::Mouse::getPosition(window));
-        auto result = g.handle_click(mouse_pos_world);
-        if (!result) {
-          spdlog::warn("click failed with: {}", result.error().message());
+    if (on_demand) {
+      if (frames_to_draw == 0 or !window.isOpen()) {
+        // waitEvent would not return when the textures arrive
+        if (g.assets_loading()) {
+          sf::sleep(sf::milliseconds(5));
         }
-        spdlog::info("click at ({}, {})", mouse_pos_world.x, mouse_pos_world.y);
+        continue;
       }
+      --frames_to_draw;
     }
 
     if (show_overlay) {
@@ -498,13 +609,27 @@ outcome::result<void> Main(const std::vector<std::string>& args) {
       const auto window_size_text =
           fmt::format("window size: {}x{}", window_size.x, window_size.y);
       const auto viewport_text = fmt::format(
-          "viewport: {} {} {} {}", viewport_debug.left, viewport_debug.top,
-          viewport_debug.height, viewport_debug.width);
+          "viewport: {} {} {} {} zoom {:.1f}x", viewport.left, viewport.top,
+          viewport.height, viewport.width, camera.zoom());
 
       ImGui::SFML::Update(window, deltaClock.restart());
       ImGui::Begin("Debug info");
       ImGui::TextUnformatted(window_size_text.c_str());
       ImGui::TextUnformatted(viewport_text.c_str());
+      const auto frame_text = frame_times.summary();
+      ImGui::TextUnformatted(frame_text.c_str());
+      frame_times.plot();
+      if (ai) {
+        const auto ai_text = FormatSearchStatistics(*ai);
+        ImGui::TextUnformatted(ai_text.c_str());
+      }
+      if (remote) {
+        const auto remote_text = remote->summary();
+        ImGui::TextUnformatted(remote_text.c_str());
+      }
+      for (const auto& line : FormatTimings(registry)) {
+        ImGui::TextUnformatted(line.c_str());
+      }
       ImGui::End();
     }
 
@@ -513,18 +638,47 @@ outcome::result<void> Main(const std::vector<std::string>& args) {
 
     if (show_overlay) ImGui::SFML::Render(window);
 
-    window.display();
+    // display() sleeps to keep to the frame rate limit, so the frame time is
+    // taken before it
+    const auto frame_time = frameClock.getElapsedTime();
+    {
+      const metrics::ScopedTimer display_timer{display_timing};
+      window.display();
+    }
+    frame_times.record(frame_time);
+    frame_timing.record(std::chrono::microseconds{frame_time.asMicroseconds()});
+    frames_drawn.add();
+    if (metricsClock.getElapsedTime() >= metrics_interval) {
+      write_metrics();
+      flush_input_record();
+      metricsClock.restart();
+    }
+    if (first_frame) {
+      log_startup("first frame shown");
+      first_frame = false;
+    }
   }
 
   ImGui::SFML::Shutdown();
+  write_metrics();
+  flush_input_record();
 
   return outcome::success();
 }
 }  // namespace tictactoe
 
 int main(int argc, const char** argv) {
+  // Log from a background thread, so that the event loop never waits for the
+  // terminal; when the queue is full the oldest messages are dropped.
+  spdlog::init_thread_pool(8192, 1);
+  spdlog::set_default_logger(
+      spdlog::create_async_nb<spdlog::sinks::stdout_color_sink_mt>(
+          "tictactoe"));
+
   std::vector<std::string> args = {argv, argv + argc};
   spdlog::info("args[0]:{}", args[0]);
   auto result = tictactoe::Main(args);
+  // flushes what is still queued
+  spdlog::shutdown();
   return result ? 0 : 1;
 }
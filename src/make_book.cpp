@@ -0,0 +1,54 @@
+#include <fmt/format.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "opening_book.hpp"
+
+// Usage: make_book <board_size> [win_length] [output_dir]
+//
+// Solves every position of a small square board and writes the perfect-play
+// table that the game loads from its asset directory.
+int main(int argc, const char** argv) {
+  const std::vector<std::string> args = {argv, argv + argc};
+  if (args.size() < 2) {
+    fmt::print(stderr, "usage: {} <board_size> [win_length] [output_dir]\n",
+               args[0]);
+    return EXIT_FAILURE;
+  }
+  const int board_size = std::stoi(args[1]);
+  const int win_length = args.size() > 2 ? std::stoi(args[2]) : board_size;
+  const tictactoe::GameRules rules{board_size, board_size, win_length};
+  const std::filesystem::path dir = args.size() > 3 ? args[3] : ".";
+
+  const auto start = std::chrono::steady_clock::now();
+  const auto bytes = tictactoe::OpeningBook::generate(rules);
+  if (!bytes) {
+    fmt::print(stderr, "cannot build a book for {}x{} boards, {} in a row\n",
+               rules.rows, rules.cols, rules.win_length);
+    return EXIT_FAILURE;
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+
+  const auto path = dir / tictactoe::OpeningBook::file_name(rules);
+  std::FILE* out = std::fopen(path.string().c_str(), "wb");
+  if (out == nullptr or
+      std::fwrite(bytes.value().data(), 1, bytes.value().size(), out) !=
+          bytes.value().size()) {
+    fmt::print(stderr, "writing {} failed\n", path.string());
+    if (out != nullptr) {
+      std::fclose(out);
+    }
+    return EXIT_FAILURE;
+  }
+  std::fclose(out);
+
+  fmt::print("wrote {} ({} bytes) in {} ms\n", path.string(),
+             bytes.value().size(), elapsed.count());
+  return EXIT_SUCCESS;
+}
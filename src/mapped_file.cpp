@@ -0,0 +1,83 @@
+#include "mapped_file.hpp"
+
+#include <cerrno>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace tictactoe {
+
+outcome::result<MappedFile> MappedFile::open(const std::filesystem::path& path,
+                                             [[maybe_unused]] Access access) {
+  MappedFile mapped;
+#if defined(_WIN32)
+  std::ifstream in{path, std::ios::binary};
+  if (!in) {
+    return std::errc::no_such_file_or_directory;
+  }
+  mapped.contents_.assign(std::istreambuf_iterator<char>{in},
+                          std::istreambuf_iterator<char>{});
+  mapped.data_ = mapped.contents_.data();
+  mapped.size_ = mapped.contents_.size();
+#else
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return std::error_code{errno, std::generic_category()};
+  }
+  struct stat st {};
+  if (::fstat(fd, &st) != 0) {
+    const std::error_code ec{errno, std::generic_category()};
+    ::close(fd);
+    return ec;
+  }
+  mapped.size_ = static_cast<std::size_t>(st.st_size);
+  if (mapped.size_ > 0) {
+    void* data = ::mmap(nullptr, mapped.size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      const std::error_code ec{errno, std::generic_category()};
+      ::close(fd);
+      return ec;
+    }
+    ::madvise(data, mapped.size_,
+              access == Access::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+    mapped.data_ = static_cast<const std::uint8_t*>(data);
+    mapped.mapped_ = true;
+  }
+  ::close(fd);
+#endif
+  return mapped;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_{std::exchange(other.data_, nullptr)},
+      size_{std::exchange(other.size_, 0)},
+      mapped_{std::exchange(other.mapped_, false)},
+      // moving the vector keeps its buffer, so data_ stays valid
+      contents_{std::move(other.contents_)} {}
+
+MappedFile::~MappedFile() {
+#if !defined(_WIN32)
+  if (mapped_) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    ::munmap(const_cast<std::uint8_t*>(data_), size_);
+  }
+#endif
+}
+
+MappedFile MappedFile::in_memory(std::vector<std::uint8_t> contents) {
+  MappedFile file;
+  file.contents_ = std::move(contents);
+  file.data_ = file.contents_.data();
+  file.size_ = file.contents_.size();
+  return file;
+}
+
+}  // namespace tictactoe
@@ -0,0 +1,52 @@
+#ifndef TICTACTOE_MAPPED_FILE_H_
+#define TICTACTOE_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <outcome.hpp>
+#include <span>
+#include <vector>
+
+#include "board.hpp"
+
+namespace tictactoe {
+
+// Read-only bytes of a whole file, memory mapped so that pages are only read
+// when first touched. Where mmap is not available the file is read into
+// memory instead.
+class MappedFile {
+ public:
+  // How the bytes will be read, so the kernel can read ahead or not.
+  enum class Access {
+    // Front to back once, like game records.
+    Sequential,
+    // Scattered lookups, like opening book probes.
+    Random,
+  };
+
+  static outcome::result<MappedFile> open(const std::filesystem::path& path,
+                                          Access access);
+  // Wraps bytes that are already in memory, e.g. a freshly generated file.
+  static MappedFile in_memory(std::vector<std::uint8_t> contents);
+
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&&) = delete;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  std::span<const std::uint8_t> bytes() const { return {data_, size_}; }
+
+ private:
+  MappedFile() = default;
+
+  const std::uint8_t* data_ = nullptr;
+  std::size_t size_ = 0;
+  bool mapped_ = false;
+  std::vector<std::uint8_t> contents_;
+};
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_MAPPED_FILE_H_
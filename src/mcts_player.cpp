@@ -0,0 +1,388 @@
+#include "mcts_player.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+namespace tictactoe {
+
+namespace {
+
+constexpr std::uint64_t kTimeCheckInterval = 64;
+
+std::mt19937_64 make_rng(std::uint64_t seed, unsigned thread_index) {
+  std::seed_seq seq{static_cast<std::uint32_t>(seed),
+                    static_cast<std::uint32_t>(seed >> 32U), thread_index};
+  return std::mt19937_64{seq};
+}
+
+bool is_empty(int cell, const Engine& engine) {
+  return engine.get_field_state_at(engine.position_of(cell)) ==
+         FieldState::Empty;
+}
+
+}  // namespace
+
+// One search tree. Nodes live in a single vector and refer to each other by
+// index. Children are added one at a time, as a node's visits allow more of
+// them (progressive widening), and are linked through their next sibling, so
+// a wide board does not fill the arena with moves that are never tried.
+class MctsPlayer::Tree {
+ public:
+  Tree(const GameRules& rules, const MctsLimits& limits, std::uint64_t seed,
+       unsigned thread_index)
+      : limits_{limits}, rng_{make_rng(seed, thread_index)} {
+    const auto cells = static_cast<std::size_t>(rules.num_cells());
+    empty_cells_.reserve(cells);
+    slot_of_.resize(cells, kNotEmpty);
+    tried_.resize(cells, 0);
+  }
+
+  // Moves the root to the node for the engine's position, keeping everything
+  // searched below it, or starts over when the game did not continue from
+  // the previously searched position. Returns the playouts kept.
+  std::uint64_t prepare(const Engine& engine) {
+    const auto& played = engine.move_history();
+    std::optional<std::uint32_t> node;
+    if (!arena_.empty() and played.size() >= history_.size() and
+        std::equal(history_.begin(), history_.end(), played.begin())) {
+      node = root_;
+      for (auto m = played.begin() + static_cast<std::ptrdiff_t>(
+                                         history_.size());
+           node and m != played.end(); ++m) {
+        node = child_with_move(*node, *m);
+      }
+    }
+
+    if (node) {
+      root_ = *node;
+      if (arena_.size() > limits_.max_nodes / 2) {
+        compact();
+      }
+    } else {
+      arena_.clear();
+      arena_.push_back(Node{});
+      root_ = 0;
+    }
+
+    history_ = played;
+    work_ = engine;
+    return arena_[root_].visits;
+  }
+
+  void search(std::uint64_t playouts,
+              std::chrono::steady_clock::time_point deadline) {
+    // a playout adds at most one node, so the arena does not grow while
+    // searching, and is never reserved beyond what this move can use
+    arena_.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(
+        limits_.max_nodes, arena_.size() + playouts)));
+    for (std::uint64_t i = 0; i < playouts; ++i) {
+      if (i % kTimeCheckInterval == 0 and
+          std::chrono::steady_clock::now() > deadline) {
+        break;
+      }
+      playout();
+      ++playouts_;
+    }
+  }
+
+  // Adds the visits and wins of every move at the root to the totals.
+  void collect_root(std::vector<std::uint64_t>& visits,
+                    std::vector<double>& wins) const {
+    for (auto c = arena_[root_].first_child; c != kNoNode;
+         c = arena_[c].next_sibling) {
+      const Node& child = arena_[c];
+      const auto cell = static_cast<std::size_t>(child.move);
+      visits[cell] += child.visits;
+      wins[cell] += static_cast<double>(child.wins);
+    }
+  }
+
+  std::uint64_t take_playouts() { return std::exchange(playouts_, 0); }
+  std::size_t size() const { return arena_.size(); }
+
+ private:
+  static constexpr std::uint32_t kNoNode = UINT32_MAX;
+  static constexpr std::size_t kNotEmpty = SIZE_MAX;
+
+  struct Node {
+    std::uint32_t first_child = kNoNode;
+    std::uint32_t next_sibling = kNoNode;
+    std::uint32_t num_children = 0;
+    std::uint32_t visits = 0;
+    // Playouts through this node won by the player who made its move, with
+    // draws counting half.
+    float wins = 0.0f;
+    std::int32_t move = -1;
+  };
+
+  MctsLimits limits_;
+  std::mt19937_64 rng_;
+  std::vector<Node> arena_;
+  // The arena compact() copies into; kept to reuse its memory.
+  std::vector<Node> scratch_;
+  std::uint32_t root_ = 0;
+  // Moves leading to the root; the tree can only be reused if the game
+  // continues from there.
+  std::vector<int> history_;
+  std::optional<Engine> work_;
+  std::vector<std::uint32_t> path_;
+  std::vector<int> empty_cells_;
+  // Where each cell is in empty_cells_, kNotEmpty once it was played.
+  std::vector<std::size_t> slot_of_;
+  // Cells holding the current mark are moves a node already has a child for.
+  std::vector<std::uint32_t> tried_;
+  std::uint32_t tried_mark_ = 0;
+  std::uint64_t playouts_ = 0;
+
+  std::optional<std::uint32_t> child_with_move(std::uint32_t node,
+                                               int move) const {
+    for (auto c = arena_[node].first_child; c != kNoNode;
+         c = arena_[c].next_sibling) {
+      if (arena_[c].move == move) {
+        return c;
+      }
+    }
+    return std::nullopt;
+  }
+
+  // Copies the subtree under the root to the front of the scratch arena,
+  // dropping the branches of moves that were not played, and swaps the two.
+  void compact() {
+    auto& fresh = scratch_;
+    fresh.clear();
+    // the subtree is never larger than the arena it is in
+    fresh.reserve(arena_.size());
+    fresh.push_back(arena_[root_]);
+    fresh[0].next_sibling = kNoNode;
+    for (std::size_t i = 0; i < fresh.size(); ++i) {
+      auto c = fresh[i].first_child;
+      auto* link = &fresh[i].first_child;
+      while (c != kNoNode) {
+        const auto copy = static_cast<std::uint32_t>(fresh.size());
+        fresh.push_back(arena_[c]);
+        // fresh has room for all nodes, so link is not invalidated
+        *link = copy;
+        link = &fresh[copy].next_sibling;
+        c = arena_[c].next_sibling;
+      }
+    }
+    arena_.swap(fresh);
+    root_ = 0;
+  }
+
+  // Children a node with visits playouts through it may have.
+  std::uint32_t children_allowed(std::uint32_t visits) const {
+    return 1U + static_cast<std::uint32_t>(
+                    limits_.widening * std::sqrt(static_cast<double>(visits)));
+  }
+
+  std::uint32_t select_child(std::uint32_t node) const {
+    const double log_visits =
+        std::log(static_cast<double>(arena_[node].visits));
+    std::uint32_t best = arena_[node].first_child;
+    double best_score = -1.0;
+    for (auto c = arena_[node].first_child; c != kNoNode;
+         c = arena_[c].next_sibling) {
+      const Node& child = arena_[c];
+      if (child.visits == 0) {
+        return c;
+      }
+      const auto visits = static_cast<double>(child.visits);
+      const double score =
+          static_cast<double>(child.wins) / visits +
+          limits_.exploration * std::sqrt(log_visits / visits);
+      if (score > best_score) {
+        best_score = score;
+        best = c;
+      }
+    }
+    return best;
+  }
+
+  // Adds a child for a move picked at random among the ones node has none
+  // for yet; there must be such a move.
+  std::uint32_t add_child(std::uint32_t node) {
+    ++tried_mark_;
+    for (auto c = arena_[node].first_child; c != kNoNode;
+         c = arena_[c].next_sibling) {
+      tried_[static_cast<std::size_t>(arena_[c].move)] = tried_mark_;
+    }
+    std::uniform_int_distribution<std::size_t> pick(
+        0, empty_cells_.size() - arena_[node].num_children - 1);
+    auto untried = pick(rng_);
+    auto cell = empty_cells_.begin();
+    for (;; ++cell) {
+      if (tried_[static_cast<std::size_t>(*cell)] != tried_mark_ and
+          untried-- == 0) {
+        break;
+      }
+    }
+
+    const auto child = static_cast<std::uint32_t>(arena_.size());
+    Node added;
+    added.move = *cell;
+    added.next_sibling = arena_[node].first_child;
+    arena_.push_back(added);
+    arena_[node].first_child = child;
+    ++arena_[node].num_children;
+    return child;
+  }
+
+  void play_empty(std::size_t index) {
+    const int cell = empty_cells_[index];
+    empty_cells_[index] = empty_cells_.back();
+    slot_of_[static_cast<std::size_t>(empty_cells_[index])] = index;
+    empty_cells_.pop_back();
+    slot_of_[static_cast<std::size_t>(cell)] = kNotEmpty;
+    work_->handle_field_selected(work_->position_of(cell)).value();
+  }
+
+  void play(int cell) { play_empty(slot_of_[static_cast<std::size_t>(cell)]); }
+
+  void playout() {
+    Engine& engine = *work_;
+    const Player root_player = engine.get_active_player();
+
+    empty_cells_.clear();
+    for (int cell = 0; cell < engine.rules().num_cells(); ++cell) {
+      if (is_empty(cell, engine)) {
+        slot_of_[static_cast<std::size_t>(cell)] = empty_cells_.size();
+        empty_cells_.push_back(cell);
+      } else {
+        slot_of_[static_cast<std::size_t>(cell)] = kNotEmpty;
+      }
+    }
+
+    // selection, until a node may get another child; that one is added and
+    // the playout continues from it
+    path_.clear();
+    std::uint32_t node = root_;
+    path_.push_back(node);
+    while (!engine.maybe_winner() and !empty_cells_.empty()) {
+      const Node& n = arena_[node];
+      const bool can_widen =
+          n.num_children < empty_cells_.size() and
+          n.num_children < children_allowed(n.visits) and
+          arena_.size() < limits_.max_nodes;
+      if (can_widen) {
+        node = add_child(node);
+        play(arena_[node].move);
+        path_.push_back(node);
+        break;
+      }
+      if (n.num_children == 0) {
+        break;
+      }
+      node = select_child(node);
+      play(arena_[node].move);
+      path_.push_back(node);
+    }
+
+    // simulation
+    while (!engine.maybe_winner() and !empty_cells_.empty()) {
+      std::uniform_int_distribution<std::size_t> pick(0,
+                                                      empty_cells_.size() - 1);
+      play_empty(pick(rng_));
+    }
+
+    // backpropagation; odd depths hold moves of the player to move at the root
+    const auto winner = engine.maybe_winner();
+    for (std::size_t depth = 0; depth < path_.size(); ++depth) {
+      Node& n = arena_[path_[depth]];
+      ++n.visits;
+      if (!winner) {
+        n.wins += 0.5f;
+      } else if ((*winner == root_player) == (depth % 2 == 1)) {
+        n.wins += 1.0f;
+      }
+    }
+
+    const auto made = engine.move_history().size() - history_.size();
+    for (std::size_t i = 0; i < made; ++i) {
+      engine.unmake_move();
+    }
+  }
+};
+
+MctsPlayer::MctsPlayer(const GameRules& rules, MctsLimits limits,
+                       std::uint64_t seed)
+    : rules_{rules}, limits_{limits} {
+  const unsigned threads =
+      limits_.threads > 0 ? limits_.threads
+                          : std::max(1U, std::thread::hardware_concurrency());
+  for (unsigned t = 0; t < threads; ++t) {
+    trees_.push_back(std::make_unique<Tree>(rules_, limits_, seed, t));
+  }
+}
+
+MctsPlayer::~MctsPlayer() = default;
+MctsPlayer::MctsPlayer(MctsPlayer&&) noexcept = default;
+MctsPlayer& MctsPlayer::operator=(MctsPlayer&&) noexcept = default;
+
+outcome::result<Position> MctsPlayer::choose_move(const Engine& engine) {
+  if (engine.rules() != rules_) {
+    return std::errc::invalid_argument;
+  }
+  int first_empty = 0;
+  while (first_empty < rules_.num_cells() and !is_empty(first_empty, engine)) {
+    ++first_empty;
+  }
+  if (engine.maybe_winner() or first_empty == rules_.num_cells()) {
+    return std::errc::operation_not_permitted;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  const auto deadline = start + limits_.time_budget;
+  const auto threads = static_cast<unsigned>(trees_.size());
+  stats_ = MctsStatistics{};
+  stats_.threads = threads;
+
+  for (auto& tree : trees_) {
+    stats_.reused_playouts += tree->prepare(engine);
+  }
+
+  const auto share = [&](unsigned t) {
+    return limits_.playouts / threads +
+           (t < limits_.playouts % threads ? 1U : 0U);
+  };
+  std::vector<std::thread> pool;
+  for (unsigned t = 1; t < threads; ++t) {
+    pool.emplace_back([&, t] { trees_[t]->search(share(t), deadline); });
+  }
+  trees_[0]->search(share(0), deadline);
+  for (auto& thread : pool) {
+    thread.join();
+  }
+
+  const auto cells = static_cast<std::size_t>(rules_.num_cells());
+  std::vector<std::uint64_t> visits(cells, 0);
+  std::vector<double> wins(cells, 0.0);
+  for (auto& tree : trees_) {
+    tree->collect_root(visits, wins);
+    stats_.playouts += tree->take_playouts();
+    stats_.tree_nodes += tree->size();
+  }
+
+  // the most visited move is the most robust choice
+  const auto best = std::max_element(visits.begin(), visits.end());
+  // not even the root could be expanded when nothing was visited
+  int best_move = first_empty;
+  if (*best > 0) {
+    best_move = static_cast<int>(best - visits.begin());
+    stats_.win_rate = wins[static_cast<std::size_t>(best_move)] /
+                      static_cast<double>(*best);
+  }
+
+  stats_.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+
+  return engine.position_of(best_move);
+}
+
+}  // namespace tictactoe
@@ -0,0 +1,75 @@
+#ifndef TICTACTOE_MCTS_PLAYER_H_
+#define TICTACTOE_MCTS_PLAYER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <outcome.hpp>
+#include <vector>
+
+#include "engine.hpp"
+
+namespace tictactoe {
+
+struct MctsLimits {
+  // Playouts per move, summed over all threads.
+  std::uint64_t playouts = 20'000;
+  std::chrono::milliseconds time_budget{1000};
+  // 0 uses std::thread::hardware_concurrency().
+  unsigned threads = 1;
+  // Nodes each thread's tree may hold before it stops growing.
+  std::uint32_t max_nodes = 1U << 20U;
+  double exploration = 1.4;
+  // A node may have 1 + widening * sqrt(visits) children; the moves after
+  // that are only tried once it has been visited more often.
+  double widening = 2.0;
+};
+
+struct MctsStatistics {
+  std::uint64_t playouts = 0;
+  // Playouts already below the root when the search started.
+  std::uint64_t reused_playouts = 0;
+  std::uint64_t tree_nodes = 0;
+  unsigned threads = 1;
+  // Share of the playouts through the chosen move that its player won.
+  double win_rate = 0.0;
+  std::chrono::microseconds elapsed{0};
+
+  double playouts_per_second() const {
+    const auto us = static_cast<double>(elapsed.count());
+    return us > 0.0 ? static_cast<double>(playouts) * 1e6 / us : 0.0;
+  }
+};
+
+// Computer opponent for boards too large for exhaustive search: Monte Carlo
+// tree search with UCT selection, progressive widening and uniformly random
+// playouts. Every thread grows its own tree (root parallelisation) in a
+// node arena and the root statistics are merged to pick the
+// most visited move. Trees are kept between moves and re-rooted at the
+// position the game has reached, as long as it follows on from the last
+// searched one.
+class MctsPlayer {
+ public:
+  MctsPlayer(const GameRules& rules, MctsLimits limits,
+             std::uint64_t seed = 0x5EED);
+  ~MctsPlayer();
+  MctsPlayer(MctsPlayer&&) noexcept;
+  MctsPlayer& operator=(MctsPlayer&&) noexcept;
+
+  outcome::result<Position> choose_move(const Engine& engine);
+
+  const MctsStatistics& last_search_statistics() const { return stats_; }
+  const MctsLimits& limits() const { return limits_; }
+
+ private:
+  class Tree;
+
+  GameRules rules_;
+  MctsLimits limits_;
+  std::vector<std::unique_ptr<Tree>> trees_;
+  MctsStatistics stats_;
+};
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_MCTS_PLAYER_H_
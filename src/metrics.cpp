@@ -0,0 +1,121 @@
+#include "metrics.hpp"
+
+#include <array>
+#include <cstdio>
+#include <system_error>
+
+namespace tictactoe::metrics {
+
+namespace {
+
+std::string seconds_of(std::uint64_t ns) {
+  std::array<char, 32> text{};
+  std::snprintf(text.data(), text.size(), "%.9g",
+                static_cast<double>(ns) * 1e-9);
+  return text.data();
+}
+
+void append_header(std::string& out, const std::string& name,
+                   const std::string& help, std::string_view type) {
+  out += "# HELP " + name + " " + help + "\n";
+  out += "# TYPE " + name + " ";
+  out += type;
+  out += "\n";
+}
+
+}  // namespace
+
+std::size_t next_timing_slot() {
+  static std::atomic<std::size_t> next{0};
+  return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+Registry& Registry::global() {
+  static Registry registry;
+  return registry;
+}
+
+Timing& Registry::timing(std::string_view name, std::string_view help,
+                         std::uint32_t sample_every) {
+  std::lock_guard lock{mutex_};
+  if (const auto it = timings_.find(name); it != timings_.end()) {
+    return it->second;
+  }
+  return timings_
+      .try_emplace(std::string{name}, enabled_, std::string{help},
+                   sample_every)
+      .first->second;
+}
+
+Counter& Registry::counter(std::string_view name, std::string_view help) {
+  std::lock_guard lock{mutex_};
+  if (const auto it = counters_.find(name); it != counters_.end()) {
+    return it->second;
+  }
+  return counters_.try_emplace(std::string{name}, std::string{help})
+      .first->second;
+}
+
+std::vector<TimingSummary> Registry::timing_summaries() const {
+  std::lock_guard lock{mutex_};
+  std::vector<TimingSummary> summaries;
+  summaries.reserve(timings_.size());
+  for (const auto& [name, timing] : timings_) {
+    const auto& histogram = timing.histogram();
+    TimingSummary summary;
+    summary.name = name;
+    summary.count = histogram.count() * timing.sample_every();
+    summary.p50 = std::chrono::nanoseconds{histogram.percentile(0.50)};
+    summary.p99 = std::chrono::nanoseconds{histogram.percentile(0.99)};
+    summaries.push_back(std::move(summary));
+  }
+  return summaries;
+}
+
+std::string Registry::prometheus_text() const {
+  std::lock_guard lock{mutex_};
+  std::string out;
+  for (const auto& [name, timing] : timings_) {
+    const auto& histogram = timing.histogram();
+    append_header(out, name, timing.help(), "summary");
+    out += name + "{quantile=\"0.5\"} " +
+           seconds_of(histogram.percentile(0.50)) + "\n";
+    out += name + "{quantile=\"0.99\"} " +
+           seconds_of(histogram.percentile(0.99)) + "\n";
+    out += name + "_sum " +
+           seconds_of(timing.sum_ns() * timing.sample_every()) + "\n";
+    out += name + "_count " +
+           std::to_string(histogram.count() * timing.sample_every()) + "\n";
+  }
+  for (const auto& [name, counter] : counters_) {
+    append_header(out, name, counter.help(), "counter");
+    out += name + " " + std::to_string(counter.value()) + "\n";
+  }
+  return out;
+}
+
+outcome::result<void> Registry::write_prometheus(
+    const std::filesystem::path& path) const {
+  const auto text = prometheus_text();
+  // written next to the target and renamed, so scrapers never see half a file
+  auto partial = path;
+  partial += ".partial";
+  std::FILE* file = std::fopen(partial.string().c_str(), "wb");
+  if (file == nullptr) {
+    return std::errc::io_error;
+  }
+  const bool written =
+      std::fwrite(text.data(), 1, text.size(), file) == text.size();
+  if (std::fclose(file) != 0 or !written) {
+    return std::errc::io_error;
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(partial, path, ec);
+  if (ec) {
+    return ec;
+  }
+  return outcome::success();
+}
+
+}  // namespace tictactoe::metrics
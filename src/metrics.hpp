@@ -0,0 +1,162 @@
+#ifndef TICTACTOE_METRICS_H_
+#define TICTACTOE_METRICS_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <outcome.hpp>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "board.hpp"
+#include "latency_histogram.hpp"
+
+namespace tictactoe::metrics {
+
+// A process-wide index for the per-thread call counters of a Timing.
+std::size_t next_timing_slot();
+
+// Durations of one instrumented piece of code, see ScopedTimer. With
+// sample_every > 1 only every n-th call to this timing on a thread is timed,
+// which keeps frequently called functions cheap; the exported count and sum
+// are scaled back up accordingly.
+class Timing {
+ public:
+  Timing(const std::atomic<bool>& enabled, std::string help,
+         std::uint32_t sample_every)
+      : enabled_{enabled},
+        help_{std::move(help)},
+        every_{sample_every},
+        slot_{next_timing_slot()} {}
+
+  bool should_record() const {
+    if (!enabled_.load(std::memory_order_relaxed)) {
+      return false;
+    }
+    if (every_ <= 1) {
+      return true;
+    }
+    // counted per thread, so that threads calling the same timing do not
+    // contend for one cache line
+    thread_local std::vector<std::uint32_t> calls;
+    if (calls.size() <= slot_) {
+      calls.resize(slot_ + 1);
+    }
+    return ++calls[slot_] % every_ == 0;
+  }
+
+  void record(std::chrono::nanoseconds elapsed) {
+    const auto ns = static_cast<std::uint64_t>(elapsed.count());
+    histogram_.record(ns);
+    sum_ns_.fetch_add(ns, std::memory_order_relaxed);
+  }
+
+  const LatencyHistogram& histogram() const { return histogram_; }
+  std::uint64_t sum_ns() const {
+    return sum_ns_.load(std::memory_order_relaxed);
+  }
+  const std::string& help() const { return help_; }
+  std::uint32_t sample_every() const { return every_; }
+
+ private:
+  const std::atomic<bool>& enabled_;
+  std::string help_;
+  std::uint32_t every_;
+  std::size_t slot_;
+  LatencyHistogram histogram_;
+  std::atomic<std::uint64_t> sum_ns_{0};
+};
+
+// Monotonic count of events, e.g. clicks or frames drawn.
+class Counter {
+ public:
+  explicit Counter(std::string help) : help_{std::move(help)} {}
+
+  void add(std::uint64_t n = 1) {
+    value_.fetch_add(n, std::memory_order_relaxed);
+  }
+  std::uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+  const std::string& help() const { return help_; }
+
+ private:
+  std::string help_;
+  std::atomic<std::uint64_t> value_{0};
+};
+
+// Times the scope it lives in into a Timing, unless recording is disabled or
+// the call is not sampled; then it costs a load and a branch.
+class ScopedTimer {
+ public:
+  explicit ScopedTimer(Timing& timing)
+      : timing_{timing.should_record() ? &timing : nullptr} {
+    if (timing_ != nullptr) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+  ~ScopedTimer() {
+    if (timing_ != nullptr) {
+      timing_->record(std::chrono::steady_clock::now() - start_);
+    }
+  }
+
+ private:
+  Timing* timing_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+// Percentiles of one Timing at the time of Registry::timing_summaries().
+struct TimingSummary {
+  std::string name;
+  std::uint64_t count = 0;
+  std::chrono::nanoseconds p50{0};
+  std::chrono::nanoseconds p99{0};
+};
+
+// Owns all timings and counters of a process by name. Registering takes a
+// lock, so callers look their metric up once and keep the reference, which
+// stays valid for the lifetime of the registry. Recording starts disabled,
+// so that programs which never export the metrics pay nothing for them.
+class Registry {
+ public:
+  // The registry the UI records into.
+  static Registry& global();
+
+  // Names follow Prometheus conventions, e.g. "tictactoe_frame_seconds".
+  // Asking for a name again returns the metric registered first.
+  Timing& timing(std::string_view name, std::string_view help,
+                 std::uint32_t sample_every = 1);
+  Counter& counter(std::string_view name, std::string_view help);
+
+  void set_enabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  std::vector<TimingSummary> timing_summaries() const;
+  // Timings as summaries with p50 and p99 quantiles in seconds and counters
+  // as counters, in the Prometheus text exposition format.
+  std::string prometheus_text() const;
+  // Replaces the file, e.g. for the node exporter's textfile collector.
+  outcome::result<void> write_prometheus(
+      const std::filesystem::path& path) const;
+
+ private:
+  std::atomic<bool> enabled_{false};
+  mutable std::mutex mutex_;
+  // map nodes never move, so handed out references stay valid
+  std::map<std::string, Timing, std::less<>> timings_;
+  std::map<std::string, Counter, std::less<>> counters_;
+};
+
+}  // namespace tictactoe::metrics
+
+#endif  // TICTACTOE_METRICS_H_
@@ -0,0 +1,324 @@
+#include "negamax_player.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <system_error>
+
+#include "win_lines.hpp"
+
+namespace tictactoe {
+
+namespace {
+
+constexpr int kInfinity = std::numeric_limits<int>::max() / 2;
+constexpr std::uint64_t kTimeCheckInterval = 1024;
+
+// Win scores are stored in the table relative to the node they were found in
+// rather than to the root, so that they stay valid when reached via a
+// different path length.
+int score_to_tt(int score, int ply) {
+  if (score > NegamaxPlayer::kWinThreshold) {
+    return score + ply;
+  }
+  if (score < -NegamaxPlayer::kWinThreshold) {
+    return score - ply;
+  }
+  return score;
+}
+
+int score_from_tt(int score, int ply) {
+  if (score > NegamaxPlayer::kWinThreshold) {
+    return score - ply;
+  }
+  if (score < -NegamaxPlayer::kWinThreshold) {
+    return score + ply;
+  }
+  return score;
+}
+
+FieldState stone_of(Player p) {
+  return p == Player::CrossPlayer ? FieldState::Cross : FieldState::Circle;
+}
+
+}  // namespace
+
+NegamaxPlayer::NegamaxPlayer(const GameRules& rules, SearchLimits limits,
+                             unsigned tt_size_log2)
+    : rules_{rules},
+      limits_{limits},
+      zobrist_{static_cast<std::size_t>(rules.num_cells())},
+      tt_{tt_size_log2},
+      segments_{winning_segments(rules)},
+      // static ordering: cells taking part in more segments are tried first
+      cell_weights_{segments_per_cell(rules)},
+      history_(static_cast<std::size_t>(rules.num_cells()), 0),
+      // plies run from 0 at the root to num_cells on a full board
+      move_buffer_(static_cast<std::size_t>(rules.num_cells() + 1) *
+                   static_cast<std::size_t>(rules.num_cells())) {}
+
+std::span<int> NegamaxPlayer::empty_cells(const Engine& engine, int ply) {
+  const auto num_cells = static_cast<std::size_t>(rules_.num_cells());
+  const std::span<int> row{
+      move_buffer_.data() + static_cast<std::size_t>(ply) * num_cells,
+      num_cells};
+  std::size_t count = 0;
+  for (int cell = 0; cell < rules_.num_cells(); ++cell) {
+    if (engine.get_field_state_at(engine.position_of(cell)) ==
+        FieldState::Empty) {
+      row[count++] = cell;
+    }
+  }
+  return row.first(count);
+}
+
+std::uint64_t NegamaxPlayer::hash_of(const Engine& engine) const {
+  std::uint64_t hash = 0;
+  for (int cell = 0; cell < rules_.num_cells(); ++cell) {
+    const auto idx = static_cast<std::size_t>(cell);
+    switch (engine.get_field_state_at(engine.position_of(cell))) {
+      case FieldState::Circle:
+        hash ^= zobrist_.key(idx, Player::CirclePlayer);
+        break;
+      case FieldState::Cross:
+        hash ^= zobrist_.key(idx, Player::CrossPlayer);
+        break;
+      case FieldState::Empty:
+        break;
+    }
+  }
+  return hash;
+}
+
+// The table move goes first, the rest is sorted in place; ties are broken by
+// the cell index, so that the order does not depend on the previous one.
+void NegamaxPlayer::order_moves(std::span<int> moves, int tt_move) const {
+  auto rest = moves.begin();
+  if (const auto it = std::find(moves.begin(), moves.end(), tt_move);
+      it != moves.end()) {
+    std::iter_swap(moves.begin(), it);
+    ++rest;
+  }
+  std::sort(rest, moves.end(), [&](int a, int b) {
+    const auto ia = static_cast<std::size_t>(a);
+    const auto ib = static_cast<std::size_t>(b);
+    if (history_[ia] != history_[ib]) {
+      return history_[ia] > history_[ib];
+    }
+    if (cell_weights_[ia] != cell_weights_[ib]) {
+      return cell_weights_[ia] > cell_weights_[ib];
+    }
+    return a < b;
+  });
+}
+
+// Heuristic score from the point of view of the player to move: every
+// winning segment still open to only one side counts quadratically in the
+// number of its stones.
+int NegamaxPlayer::evaluate(const Engine& engine) const {
+  const auto own = stone_of(engine.get_active_player());
+  const auto k = static_cast<std::size_t>(rules_.win_length);
+  int score = 0;
+
+  for (std::size_t begin = 0; begin < segments_.size(); begin += k) {
+    int mine = 0;
+    int theirs = 0;
+    for (std::size_t i = begin; i < begin + k; ++i) {
+      const auto state =
+          engine.get_field_state_at(engine.position_of(segments_[i]));
+      if (state == own) {
+        ++mine;
+      } else if (state != FieldState::Empty) {
+        ++theirs;
+      }
+    }
+    if (theirs == 0) {
+      score += mine * mine;
+    } else if (mine == 0) {
+      score -= theirs * theirs;
+    }
+  }
+
+  return score;
+}
+
+int NegamaxPlayer::negamax(Engine& engine, std::uint64_t hash, int depth,
+                           int ply, int alpha, int beta) {
+  ++stats_.nodes;
+  if (stats_.nodes % kTimeCheckInterval == 0 and
+      std::chrono::steady_clock::now() > deadline_) {
+    aborted_ = true;
+  }
+  if (aborted_) {
+    return 0;
+  }
+
+  // The previous move decided the game, so the side to move has lost.
+  if (engine.maybe_winner()) {
+    return -(kWinScore - ply);
+  }
+
+  const auto moves = empty_cells(engine, ply);
+  if (moves.empty()) {
+    return 0;
+  }
+  if (depth == 0) {
+    return evaluate(engine);
+  }
+
+  ++stats_.tt_probes;
+  int tt_move = -1;
+  if (const auto* entry = tt_.probe(hash)) {
+    ++stats_.tt_hits;
+    tt_move = entry->best_move;
+    if (entry->depth >= depth) {
+      const int score = score_from_tt(entry->score, ply);
+      if (entry->bound == Bound::Exact) {
+        return score;
+      }
+      if (entry->bound == Bound::Lower) {
+        alpha = std::max(alpha, score);
+      } else {
+        beta = std::min(beta, score);
+      }
+      if (alpha >= beta) {
+        return score;
+      }
+    }
+  }
+
+  order_moves(moves, tt_move);
+
+  const int alpha_orig = alpha;
+  const Player mover = engine.get_active_player();
+  int best_score = -kInfinity;
+  int best_move = -1;
+
+  for (const int move : moves) {
+    const auto pos = engine.position_of(move);
+    if (!engine.handle_field_selected(pos)) {
+      continue;
+    }
+
+    const auto cell = static_cast<std::size_t>(move);
+    const int score = -negamax(engine, hash ^ zobrist_.key(cell, mover),
+                               depth - 1, ply + 1, -beta, -alpha);
+    engine.unmake_move();
+    if (aborted_) {
+      return 0;
+    }
+
+    if (score > best_score) {
+      best_score = score;
+      best_move = move;
+    }
+    alpha = std::max(alpha, score);
+    if (alpha >= beta) {
+      history_[cell] += static_cast<std::uint32_t>(depth * depth);
+      break;
+    }
+  }
+
+  TTEntry entry;
+  entry.key = hash;
+  entry.score = score_to_tt(best_score, ply);
+  entry.best_move = best_move;
+  entry.depth = static_cast<std::int16_t>(depth);
+  entry.bound = best_score <= alpha_orig ? Bound::Upper
+                : best_score >= beta     ? Bound::Lower
+                                         : Bound::Exact;
+  tt_.store(entry);
+
+  return best_score;
+}
+
+outcome::result<Position> NegamaxPlayer::choose_move(const Engine& engine) {
+  if (engine.rules() != rules_) {
+    return std::errc::invalid_argument;
+  }
+  if (engine.maybe_winner()) {
+    return std::errc::operation_not_permitted;
+  }
+
+  const auto moves = empty_cells(engine, 0);
+  if (moves.empty()) {
+    return std::errc::operation_not_permitted;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  deadline_ = start + limits_.time_budget;
+  aborted_ = false;
+  stats_ = SearchStatistics{};
+
+  if (book_) {
+    if (const auto entry = book_->probe(engine)) {
+      stats_.from_book = true;
+      stats_.solved = true;
+      stats_.completed_depth = entry->plies_to_end;
+      stats_.score = entry->value == GameValue::Draw
+                         ? 0
+                         : (kWinScore - entry->plies_to_end) *
+                               static_cast<int>(entry->value);
+      stats_.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start);
+      return entry->best_move;
+    }
+  }
+  std::fill(history_.begin(), history_.end(), 0U);
+
+  const auto root_hash = hash_of(engine);
+  const Player mover = engine.get_active_player();
+  const int max_depth =
+      limits_.max_depth > 0
+          ? std::min(limits_.max_depth, static_cast<int>(moves.size()))
+          : static_cast<int>(moves.size());
+
+  order_moves(moves, -1);
+  int best_move = moves.front();
+
+  // the one copy of the search; moves are made and taken back on it
+  Engine work = engine;
+  for (int depth = 1; depth <= max_depth; ++depth) {
+    int alpha = -kInfinity;
+    int iteration_best = -1;
+
+    for (const int move : moves) {
+      if (!work.handle_field_selected(work.position_of(move))) {
+        continue;
+      }
+      const auto cell = static_cast<std::size_t>(move);
+      const int score = -negamax(work, root_hash ^ zobrist_.key(cell, mover),
+                                 depth - 1, 1, -kInfinity, -alpha);
+      work.unmake_move();
+      if (aborted_) {
+        break;
+      }
+      if (score > alpha) {
+        alpha = score;
+        iteration_best = move;
+      }
+    }
+
+    if (aborted_ or iteration_best < 0) {
+      break;
+    }
+
+    best_move = iteration_best;
+    stats_.completed_depth = depth;
+    stats_.score = alpha;
+    order_moves(moves, best_move);
+
+    if (std::abs(alpha) > kWinThreshold or
+        depth == static_cast<int>(moves.size())) {
+      stats_.solved = true;
+      break;
+    }
+  }
+
+  stats_.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+
+  return engine.position_of(best_move);
+}
+
+}  // namespace tictactoe
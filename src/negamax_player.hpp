@@ -0,0 +1,94 @@
+#ifndef TICTACTOE_NEGAMAX_PLAYER_H_
+#define TICTACTOE_NEGAMAX_PLAYER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <outcome.hpp>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "engine.hpp"
+#include "opening_book.hpp"
+#include "transposition_table.hpp"
+#include "zobrist.hpp"
+
+namespace tictactoe {
+
+struct SearchLimits {
+  std::chrono::milliseconds time_budget{1000};
+  // 0 searches until the game tree is exhausted or time runs out.
+  int max_depth = 0;
+};
+
+struct SearchStatistics {
+  std::uint64_t nodes = 0;
+  std::uint64_t tt_probes = 0;
+  std::uint64_t tt_hits = 0;
+  std::chrono::microseconds elapsed{0};
+  int completed_depth = 0;
+  int score = 0;
+  bool solved = false;
+  bool from_book = false;
+
+  double nodes_per_second() const {
+    const auto us = static_cast<double>(elapsed.count());
+    return us > 0.0 ? static_cast<double>(nodes) * 1e6 / us : 0.0;
+  }
+
+  double tt_hit_rate() const {
+    return tt_probes > 0
+               ? static_cast<double>(tt_hits) / static_cast<double>(tt_probes)
+               : 0.0;
+  }
+};
+
+// Computer opponent: iterative-deepening negamax with alpha-beta pruning,
+// a Zobrist-hashed transposition table and history-based move ordering.
+// Small boards are solved exactly; larger ones are searched as deep as the
+// time budget allows and leaves are scored by counting open winning segments.
+class NegamaxPlayer {
+ public:
+  static constexpr int kWinScore = 1'000'000;
+  static constexpr int kWinThreshold = kWinScore - 100'000;
+
+  NegamaxPlayer(const GameRules& rules, SearchLimits limits,
+                unsigned tt_size_log2 = 20);
+
+  outcome::result<Position> choose_move(const Engine& engine);
+
+  // Positions found in the book are answered from it without searching.
+  void set_opening_book(std::shared_ptr<const OpeningBook> book) {
+    book_ = std::move(book);
+  }
+
+  const SearchStatistics& last_search_statistics() const { return stats_; }
+  const SearchLimits& limits() const { return limits_; }
+
+ private:
+  GameRules rules_;
+  SearchLimits limits_;
+  ZobristKeys zobrist_;
+  TranspositionTable tt_;
+  std::vector<int> segments_;
+  std::vector<int> cell_weights_;
+  std::vector<std::uint32_t> history_;
+  // one row of num_cells moves per ply, so that the search never allocates
+  std::vector<int> move_buffer_;
+  SearchStatistics stats_;
+  std::shared_ptr<const OpeningBook> book_;
+  std::chrono::steady_clock::time_point deadline_;
+  bool aborted_ = false;
+
+  int negamax(Engine& engine, std::uint64_t hash, int depth, int ply,
+              int alpha, int beta);
+  int evaluate(const Engine& engine) const;
+  void order_moves(std::span<int> moves, int tt_move) const;
+  std::span<int> empty_cells(const Engine& engine, int ply);
+  std::uint64_t hash_of(const Engine& engine) const;
+};
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_NEGAMAX_PLAYER_H_
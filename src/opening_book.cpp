@@ -0,0 +1,279 @@
+#include "opening_book.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+
+#include "win_lines.hpp"
+
+namespace tictactoe {
+
+namespace {
+
+constexpr std::array<std::uint8_t, 4> kMagic = {'T', 'T', 'T', 'B'};
+constexpr std::uint8_t kVersion = 2;
+constexpr std::size_t kHeaderSize = 16;
+constexpr std::size_t kEntrySize = 8;
+
+// Scores count down from kWinScore by one per ply, so that quicker wins and
+// slower losses are preferred. Must exceed the longest game.
+constexpr int kWinScore = 64;
+
+bool is_valid_book_rules(const GameRules& rules) {
+  return rules.rows == rules.cols and
+         rules.num_cells() <= OpeningBook::kMaxCells and
+         Engine::create_engine(rules).has_value();
+}
+
+// A board given as stone masks, packed as by BoardSymmetry::pack.
+std::uint32_t board_key(std::uint32_t crosses, std::uint32_t circles,
+                        const BoardSymmetry& symmetry) {
+  constexpr auto kCross = static_cast<std::uint32_t>(FieldState::Cross);
+  constexpr auto kCircle = static_cast<std::uint32_t>(FieldState::Circle);
+  std::uint32_t key = 0;
+  for (int cell = 0; cell < symmetry.num_cells(); ++cell) {
+    const auto bit = static_cast<unsigned>(cell);
+    const std::uint32_t state = ((crosses >> bit) & 1U) * kCross +
+                                ((circles >> bit) & 1U) * kCircle;
+    key |= state << symmetry.packed_shift(cell);
+  }
+  return key;
+}
+
+void put_u32(std::vector<std::uint8_t>& out, std::uint32_t value) {
+  for (unsigned byte = 0; byte < 4; ++byte) {
+    out.push_back(static_cast<std::uint8_t>(value >> (8U * byte)));
+  }
+}
+
+std::uint32_t get_u32(const std::uint8_t* in) {
+  std::uint32_t value = 0;
+  for (unsigned byte = 0; byte < 4; ++byte) {
+    value |= std::uint32_t{in[byte]} << (8U * byte);
+  }
+  return value;
+}
+
+// Exhaustive negamax over every reachable position, memoised on the
+// canonical board. No pruning, since every stored score has to be exact.
+class BookGenerator {
+ public:
+  explicit BookGenerator(const GameRules& rules)
+      : cells_{rules.num_cells()}, symmetry_{rules.rows} {
+    const auto segments = winning_segments(rules);
+    const auto k = static_cast<std::size_t>(rules.win_length);
+    segments_through_.resize(static_cast<std::size_t>(cells_));
+    for (std::size_t first = 0; first < segments.size(); first += k) {
+      std::uint32_t mask = 0;
+      for (std::size_t i = first; i < first + k; ++i) {
+        mask |= 1U << static_cast<unsigned>(segments[i]);
+      }
+      for (std::size_t i = first; i < first + k; ++i) {
+        segments_through_[static_cast<std::size_t>(segments[i])].push_back(
+            mask);
+      }
+    }
+  }
+
+  void run() { solve(0, 0, true); }
+
+  // Entries sorted by canonical key, in file format.
+  std::vector<std::uint8_t> entries() const {
+    std::vector<std::pair<std::uint32_t, Entry>> sorted{memo_.begin(),
+                                                        memo_.end()};
+    std::sort(sorted.begin(), sorted.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::vector<std::uint8_t> out;
+    out.reserve(sorted.size() * kEntrySize);
+    for (const auto& [key, entry] : sorted) {
+      put_u32(out, key);
+      out.push_back(static_cast<std::uint8_t>(entry.score));
+      out.push_back(entry.move);
+      out.push_back(0);
+      out.push_back(0);
+    }
+    return out;
+  }
+
+  std::size_t size() const { return memo_.size(); }
+
+ private:
+  struct Entry {
+    std::int8_t score;
+    std::uint8_t move;
+  };
+
+  int cells_;
+  BoardSymmetry symmetry_;
+  std::vector<std::vector<std::uint32_t>> segments_through_;
+  std::unordered_map<std::uint32_t, Entry> memo_;
+
+  bool completes_segment(std::uint32_t stones, int cell) const {
+    const auto& masks = segments_through_[static_cast<std::size_t>(cell)];
+    return std::any_of(masks.begin(), masks.end(), [&](std::uint32_t mask) {
+      return (stones & mask) == mask;
+    });
+  }
+
+  // Score of the position for the player to move; positive wins.
+  int solve(std::uint32_t crosses, std::uint32_t circles, bool cross_to_move) {
+    const auto canonical = symmetry_.canonicalize_packed(
+        board_key(crosses, circles, symmetry_));
+    const auto key = static_cast<std::uint32_t>(canonical.key);
+    if (const auto it = memo_.find(key); it != memo_.end()) {
+      return it->second.score;
+    }
+
+    const std::uint32_t occupied = crosses | circles;
+    int best_score = std::numeric_limits<int>::min();
+    int best_move = -1;
+    for (int cell = 0; cell < cells_; ++cell) {
+      const std::uint32_t bit = 1U << static_cast<unsigned>(cell);
+      if ((occupied & bit) != 0) {
+        continue;
+      }
+
+      const std::uint32_t mine = (cross_to_move ? crosses : circles) | bit;
+      int score = kWinScore - 1;
+      if (!completes_segment(mine, cell)) {
+        score = cross_to_move ? -solve(mine, circles, false)
+                              : -solve(crosses, mine, true);
+        // one ply further from the end of the game
+        score += score > 0 ? -1 : score < 0 ? 1 : 0;
+      }
+      if (score > best_score) {
+        best_score = score;
+        best_move = cell;
+      }
+    }
+
+    if (best_move < 0) {
+      return 0;  // full board, not stored
+    }
+    memo_.emplace(key,
+                  Entry{static_cast<std::int8_t>(best_score),
+                        static_cast<std::uint8_t>(symmetry_.map_cell(
+                            canonical.transform, best_move))});
+    return best_score;
+  }
+};
+
+}  // namespace
+
+OpeningBook::OpeningBook(MappedFile file, const GameRules& rules,
+                         std::size_t size)
+    : file_{std::move(file)},
+      rules_{rules},
+      size_{size},
+      symmetry_{rules.rows} {}
+
+std::string OpeningBook::file_name(const GameRules& rules) {
+  return "book_" + std::to_string(rules.rows) + "x" +
+         std::to_string(rules.cols) + "x" + std::to_string(rules.win_length) +
+         ".ttb";
+}
+
+outcome::result<std::vector<std::uint8_t>> OpeningBook::generate(
+    const GameRules& rules) {
+  if (!is_valid_book_rules(rules)) {
+    return std::errc::invalid_argument;
+  }
+
+  BookGenerator generator{rules};
+  generator.run();
+
+  std::vector<std::uint8_t> file{kMagic.begin(), kMagic.end()};
+  file.push_back(kVersion);
+  file.push_back(static_cast<std::uint8_t>(rules.rows));
+  file.push_back(static_cast<std::uint8_t>(rules.cols));
+  file.push_back(static_cast<std::uint8_t>(rules.win_length));
+  put_u32(file, static_cast<std::uint32_t>(generator.size()));
+  put_u32(file, 0);
+  const auto entries = generator.entries();
+  file.insert(file.end(), entries.begin(), entries.end());
+  return file;
+}
+
+outcome::result<OpeningBook> OpeningBook::open(
+    const std::filesystem::path& path) {
+  return from_file(
+      OUTCOME_TRYX(MappedFile::open(path, MappedFile::Access::Random)));
+}
+
+outcome::result<OpeningBook> OpeningBook::from_file(MappedFile file) {
+  const auto bytes = file.bytes();
+  if (bytes.size() < kHeaderSize or
+      !std::equal(kMagic.begin(), kMagic.end(), bytes.begin()) or
+      bytes[4] != kVersion) {
+    return std::errc::illegal_byte_sequence;
+  }
+
+  const GameRules rules{bytes[5], bytes[6], bytes[7]};
+  const std::size_t size = get_u32(&bytes[8]);
+  if (!is_valid_book_rules(rules) or
+      bytes.size() != kHeaderSize + size * kEntrySize) {
+    return std::errc::illegal_byte_sequence;
+  }
+  return OpeningBook{std::move(file), rules, size};
+}
+
+std::optional<BookProbe> OpeningBook::probe(const Engine& engine) const {
+  if (engine.rules() != rules_ or engine.maybe_winner()) {
+    return std::nullopt;
+  }
+
+  std::uint32_t crosses = 0;
+  std::uint32_t circles = 0;
+  for (int cell = 0; cell < rules_.num_cells(); ++cell) {
+    const auto pos = Position::create_position_for_engine(
+                         cell / rules_.cols, cell % rules_.cols, engine)
+                         .value();
+    const std::uint32_t bit = 1U << static_cast<unsigned>(cell);
+    switch (engine.get_field_state_at(pos)) {
+      case FieldState::Cross:
+        crosses |= bit;
+        break;
+      case FieldState::Circle:
+        circles |= bit;
+        break;
+      case FieldState::Empty:
+        break;
+    }
+  }
+  const auto canonical =
+      symmetry_.canonicalize_packed(board_key(crosses, circles, symmetry_));
+
+  // binary search over the entries, straight from the mapping
+  const std::uint8_t* entries = file_.bytes().data() + kHeaderSize;
+  std::size_t low = 0;
+  std::size_t high = size_;
+  while (low < high) {
+    const std::size_t mid = low + (high - low) / 2;
+    const std::uint8_t* entry = entries + mid * kEntrySize;
+    const std::uint32_t key = get_u32(entry);
+    if (key < canonical.key) {
+      low = mid + 1;
+    } else if (key > canonical.key) {
+      high = mid;
+    } else {
+      const int score = static_cast<std::int8_t>(entry[4]);
+      const int cell = symmetry_.unmap_cell(canonical.transform, entry[5]);
+
+      BookProbe probe{
+          score > 0 ? GameValue::Win
+                    : score < 0 ? GameValue::Loss : GameValue::Draw,
+          score != 0 ? kWinScore - std::abs(score) : 0,
+          engine.position_of(cell)};
+      return probe;
+    }
+  }
+  return std::nullopt;
+}
+
+}  // namespace tictactoe
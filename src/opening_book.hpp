@@ -0,0 +1,69 @@
+#ifndef TICTACTOE_OPENING_BOOK_H_
+#define TICTACTOE_OPENING_BOOK_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <outcome.hpp>
+#include <string>
+#include <vector>
+
+#include "board_symmetry.hpp"
+#include "engine.hpp"
+#include "game_value.hpp"
+#include "mapped_file.hpp"
+
+namespace tictactoe {
+
+struct BookProbe {
+  // From the point of view of the player to move.
+  GameValue value = GameValue::Draw;
+  // Plies until the game ends with best play; 0 for a draw.
+  int plies_to_end = 0;
+  Position best_move;
+};
+
+// Perfect-play table for square boards of up to 16 cells (3x3 and 4x4
+// tic-tac-toe), generated offline by make_book. Only the canonical form (see
+// BoardSymmetry) of every reachable undecided position is stored, in a
+// sorted array that is looked up by binary search directly in the
+// memory-mapped file.
+//
+// File layout, little endian: "TTTB", version, rows, cols, win_length, the
+// entry count as u32 and 4 reserved bytes; then one 8 byte entry per
+// position: the canonical board packed by BoardSymmetry as u32, the signed
+// score as i8 and the best move in the canonical frame.
+class OpeningBook {
+ public:
+  static constexpr int kMaxCells = 16;
+
+  // Solves every position reachable under rules and returns the file bytes.
+  static outcome::result<std::vector<std::uint8_t>> generate(
+      const GameRules& rules);
+
+  static outcome::result<OpeningBook> open(const std::filesystem::path& path);
+  static outcome::result<OpeningBook> from_file(MappedFile file);
+
+  // File name make_book uses for rules, e.g. "book_3x3x3.ttb".
+  static std::string file_name(const GameRules& rules);
+
+  const GameRules& rules() const { return rules_; }
+  std::size_t size() const { return size_; }
+
+  // Nothing for positions that are decided, full or played under different
+  // rules.
+  std::optional<BookProbe> probe(const Engine& engine) const;
+
+ private:
+  OpeningBook(MappedFile file, const GameRules& rules, std::size_t size);
+
+  MappedFile file_;
+  GameRules rules_;
+  std::size_t size_;
+  BoardSymmetry symmetry_;
+};
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_OPENING_BOOK_H_
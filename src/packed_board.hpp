@@ -0,0 +1,127 @@
+#ifndef TICTACTOE_PACKED_BOARD_H_
+#define TICTACTOE_PACKED_BOARD_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include "board.hpp"
+
+namespace tictactoe {
+
+// The fields of a board at two bits each, 32 to a 64-bit word, in the same
+// row-major order as pos2idx. A freshly created board is all Empty.
+class PackedBoard {
+ public:
+  using Word = std::uint64_t;
+  static constexpr std::size_t kBitsPerCell = 2;
+  static constexpr std::size_t kCellsPerWord = 64 / kBitsPerCell;
+
+  // Forward iterator over the fields first, first + stride, ... Strides may
+  // be negative, so lines can be walked in any direction.
+  class LineIterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = FieldState;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = FieldState;
+
+    LineIterator() = default;
+    LineIterator(const PackedBoard* board, std::ptrdiff_t cell,
+                 std::ptrdiff_t stride)
+        : board_{board}, cell_{cell}, stride_{stride} {}
+
+    FieldState operator*() const {
+      return (*board_)[static_cast<std::size_t>(cell_)];
+    }
+    LineIterator& operator++() {
+      cell_ += stride_;
+      return *this;
+    }
+    LineIterator operator++(int) {
+      auto old = *this;
+      ++*this;
+      return old;
+    }
+    bool operator==(const LineIterator& other) const {
+      return cell_ == other.cell_;
+    }
+
+   private:
+    const PackedBoard* board_ = nullptr;
+    std::ptrdiff_t cell_ = 0;
+    std::ptrdiff_t stride_ = 1;
+  };
+
+  class Line {
+   public:
+    Line(LineIterator begin, LineIterator end) : begin_{begin}, end_{end} {}
+    LineIterator begin() const { return begin_; }
+    LineIterator end() const { return end_; }
+
+   private:
+    LineIterator begin_;
+    LineIterator end_;
+  };
+
+  explicit PackedBoard(std::size_t cells)
+      : size_{cells}, words_((cells + kCellsPerWord - 1) / kCellsPerWord, 0) {}
+
+  std::size_t size() const { return size_; }
+
+  FieldState operator[](std::size_t cell) const {
+    return static_cast<FieldState>((words_[cell / kCellsPerWord] >>
+                                    shift_of(cell)) &
+                                   kCellMask);
+  }
+
+  // Like operator[], but throws std::out_of_range past the end.
+  FieldState at(std::size_t cell) const {
+    if (cell >= size_) {
+      throw std::out_of_range{"PackedBoard::at"};
+    }
+    return (*this)[cell];
+  }
+
+  void set(std::size_t cell, FieldState state) {
+    auto& word = words_[cell / kCellsPerWord];
+    const auto shift = shift_of(cell);
+    word = (word & ~(kCellMask << shift)) |
+           (static_cast<Word>(state) << shift);
+  }
+
+  // `length` fields starting at `first`, each `stride` cells after the last;
+  // all of them have to be on the board.
+  Line line(std::size_t first, std::ptrdiff_t stride,
+            std::size_t length) const {
+    const auto begin = static_cast<std::ptrdiff_t>(first);
+    const auto count = static_cast<std::ptrdiff_t>(length);
+    return Line{LineIterator{this, begin, stride},
+                LineIterator{this, begin + count * stride, stride}};
+  }
+
+  LineIterator begin() const { return LineIterator{this, 0, 1}; }
+  LineIterator end() const {
+    return LineIterator{this, static_cast<std::ptrdiff_t>(size_), 1};
+  }
+
+  // Heap memory holding the fields.
+  std::size_t bytes() const { return words_.capacity() * sizeof(Word); }
+
+ private:
+  static constexpr Word kCellMask = (Word{1} << kBitsPerCell) - 1;
+
+  static constexpr unsigned shift_of(std::size_t cell) {
+    return static_cast<unsigned>(cell % kCellsPerWord * kBitsPerCell);
+  }
+
+  std::size_t size_;
+  std::vector<Word> words_;
+};
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_PACKED_BOARD_H_
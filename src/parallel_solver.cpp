@@ -0,0 +1,270 @@
+#include "parallel_solver.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <system_error>
+#include <thread>
+#include <unordered_set>
+
+#include "win_lines.hpp"
+
+namespace tictactoe {
+
+namespace {
+
+// Layout of a table payload: bit 0 marks the slot as used, bits 1-2 hold the
+// bound, bits 3-4 the value + 1 and bits 8 and up the best move + 1.
+std::uint64_t pack_entry(int value, Bound bound, int best_move) {
+  return 1U | (static_cast<std::uint64_t>(bound) << 1U) |
+         (static_cast<std::uint64_t>(value + 1) << 3U) |
+         (static_cast<std::uint64_t>(best_move + 1) << 8U);
+}
+
+Bound entry_bound(std::uint64_t data) {
+  return static_cast<Bound>((data >> 1U) & 0x3U);
+}
+
+int entry_value(std::uint64_t data) {
+  return static_cast<int>((data >> 3U) & 0x3U) - 1;
+}
+
+int entry_best_move(std::uint64_t data) {
+  return static_cast<int>(data >> 8U) - 1;
+}
+
+}  // namespace
+
+ParallelSolver::ParallelSolver(const GameRules& rules, SolverOptions options)
+    : rules_{rules},
+      options_{options},
+      threads_{options.threads > 0
+                   ? options.threads
+                   : std::max(1U, std::thread::hardware_concurrency())},
+      zobrist_{static_cast<std::size_t>(rules.num_cells())},
+      tt_{options.tt_size_log2},
+      cell_weights_{segments_per_cell(rules)} {}
+
+std::uint64_t ParallelSolver::hash_of(const Engine& engine) const {
+  std::uint64_t hash = 0;
+  for (int cell = 0; cell < rules_.num_cells(); ++cell) {
+    const auto idx = static_cast<std::size_t>(cell);
+    switch (engine.get_field_state_at(engine.position_of(cell))) {
+      case FieldState::Circle:
+        hash ^= zobrist_.key(idx, Player::CirclePlayer);
+        break;
+      case FieldState::Cross:
+        hash ^= zobrist_.key(idx, Player::CrossPlayer);
+        break;
+      case FieldState::Empty:
+        break;
+    }
+  }
+  return hash;
+}
+
+ParallelSolver::SearchStack::SearchStack(const GameRules& rules)
+    : num_cells{static_cast<std::size_t>(rules.num_cells())},
+      // plies run from 0 at the root to num_cells on a full board
+      moves((num_cells + 1) * num_cells) {}
+
+std::span<int> ParallelSolver::SearchStack::row(int ply) {
+  return {moves.data() + static_cast<std::size_t>(ply) * num_cells,
+          num_cells};
+}
+
+// Fills the row with the empty cells: first in front, the rest by weight and
+// then by index.
+std::span<int> ParallelSolver::ordered_moves(const Engine& engine, int first,
+                                             std::span<int> row) const {
+  std::size_t count = 0;
+  for (int cell = 0; cell < rules_.num_cells(); ++cell) {
+    if (engine.get_field_state_at(engine.position_of(cell)) ==
+        FieldState::Empty) {
+      row[count++] = cell;
+    }
+  }
+  const auto moves = row.first(count);
+
+  auto rest = moves.begin();
+  if (const auto it = std::find(moves.begin(), moves.end(), first);
+      it != moves.end()) {
+    std::iter_swap(moves.begin(), it);
+    ++rest;
+  }
+  std::sort(rest, moves.end(), [&](int a, int b) {
+    const auto wa = cell_weights_[static_cast<std::size_t>(a)];
+    const auto wb = cell_weights_[static_cast<std::size_t>(b)];
+    return wa != wb ? wa > wb : a < b;
+  });
+  return moves;
+}
+
+int ParallelSolver::solve_node(Engine& engine, std::uint64_t hash, int alpha,
+                               int beta, int ply, SearchStack& stack) {
+  ++stack.nodes;
+
+  if (engine.maybe_winner()) {
+    return -1;
+  }
+
+  int tt_move = -1;
+  if (const auto data = tt_.probe(hash)) {
+    const int value = entry_value(*data);
+    tt_move = entry_best_move(*data);
+    switch (entry_bound(*data)) {
+      case Bound::Exact:
+        return value;
+      case Bound::Lower:
+        alpha = std::max(alpha, value);
+        break;
+      case Bound::Upper:
+        beta = std::min(beta, value);
+        break;
+    }
+    if (alpha >= beta) {
+      return value;
+    }
+  }
+
+  const auto moves = ordered_moves(engine, tt_move, stack.row(ply));
+  if (moves.empty()) {
+    return 0;
+  }
+
+  const int alpha_orig = alpha;
+  const Player mover = engine.get_active_player();
+  int best_value = -1;
+  int best_move = moves.front();
+
+  for (const int move : moves) {
+    if (!engine.handle_field_selected(engine.position_of(move))) {
+      continue;
+    }
+    const auto cell = static_cast<std::size_t>(move);
+    const int value = -solve_node(engine, hash ^ zobrist_.key(cell, mover),
+                                  -beta, -alpha, ply + 1, stack);
+    engine.unmake_move();
+    if (value > best_value) {
+      best_value = value;
+      best_move = move;
+    }
+    alpha = std::max(alpha, value);
+    if (alpha >= beta) {
+      break;
+    }
+  }
+
+  const Bound bound = best_value <= alpha_orig ? Bound::Upper
+                      : best_value >= beta     ? Bound::Lower
+                                               : Bound::Exact;
+  tt_.store(hash, pack_entry(best_value, bound, best_move));
+
+  return best_value;
+}
+
+void ParallelSolver::collect_tasks(Engine& engine, std::uint64_t hash,
+                                   int depth, int ply, SearchStack& stack,
+                                   std::vector<Task>& tasks) const {
+  if (depth == 0 or engine.maybe_winner()) {
+    tasks.push_back(Task{engine, hash});
+    return;
+  }
+
+  const auto moves = ordered_moves(engine, -1, stack.row(ply));
+  if (moves.empty()) {
+    tasks.push_back(Task{engine, hash});
+    return;
+  }
+
+  const Player mover = engine.get_active_player();
+  for (const int move : moves) {
+    if (!engine.handle_field_selected(engine.position_of(move))) {
+      continue;
+    }
+    collect_tasks(engine,
+                  hash ^ zobrist_.key(static_cast<std::size_t>(move), mover),
+                  depth - 1, ply + 1, stack, tasks);
+    engine.unmake_move();
+  }
+}
+
+outcome::result<SolveResult> ParallelSolver::solve(const Engine& engine) {
+  if (engine.rules() != rules_) {
+    return std::errc::invalid_argument;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  const auto root_hash = hash_of(engine);
+
+  // moves are made and taken back on this copy; only tasks copy it again
+  Engine work = engine;
+  SearchStack stack{rules_};
+  std::vector<Task> candidates;
+  collect_tasks(work, root_hash, options_.split_depth, 0, stack, candidates);
+
+  // Transpositions reach the same split position along several paths.
+  std::vector<Task> tasks;
+  std::unordered_set<std::uint64_t> seen;
+  for (auto& t : candidates) {
+    if (seen.insert(t.hash).second) {
+      tasks.push_back(std::move(t));
+    }
+  }
+
+  std::atomic<std::size_t> next_task{0};
+  std::atomic<std::uint64_t> total_nodes{0};
+  auto worker = [&] {
+    SearchStack worker_stack{rules_};
+    for (auto i = next_task.fetch_add(1); i < tasks.size();
+         i = next_task.fetch_add(1)) {
+      solve_node(tasks[i].engine, tasks[i].hash, -1, 1, 0, worker_stack);
+    }
+    total_nodes.fetch_add(worker_stack.nodes);
+  };
+
+  std::vector<std::thread> pool;
+  for (unsigned t = 1; t < threads_; ++t) {
+    pool.emplace_back(worker);
+  }
+  worker();
+  for (auto& t : pool) {
+    t.join();
+  }
+
+  // Everything below the split depth is in the table now, so resolving the
+  // root is cheap.
+  stack.nodes = total_nodes.load();
+  SolveResult result;
+  result.threads = threads_;
+  result.tasks = tasks.size();
+
+  if (engine.maybe_winner()) {
+    result.value = GameValue::Loss;
+  } else {
+    const Player mover = engine.get_active_player();
+    int best_value = -2;
+    for (const int move : ordered_moves(engine, -1, stack.row(0))) {
+      const auto pos = work.position_of(move);
+      if (!work.handle_field_selected(pos)) {
+        continue;
+      }
+      const auto cell = static_cast<std::size_t>(move);
+      const int value = -solve_node(
+          work, root_hash ^ zobrist_.key(cell, mover), -1, 1, 1, stack);
+      work.unmake_move();
+      if (value > best_value) {
+        best_value = value;
+        result.best_move = pos;
+      }
+    }
+    // a full board without a winner is a draw
+    result.value = static_cast<GameValue>(best_value < -1 ? 0 : best_value);
+  }
+
+  result.nodes = stack.nodes;
+  result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+  return result;
+}
+
+}  // namespace tictactoe
@@ -0,0 +1,83 @@
+#ifndef TICTACTOE_PARALLEL_SOLVER_H_
+#define TICTACTOE_PARALLEL_SOLVER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <outcome.hpp>
+#include <span>
+#include <vector>
+
+#include "engine.hpp"
+#include "game_value.hpp"
+#include "transposition_table.hpp"
+#include "zobrist.hpp"
+
+namespace tictactoe {
+
+struct SolverOptions {
+  // 0 uses std::thread::hardware_concurrency().
+  unsigned threads = 0;
+  // Positions this many moves below the root are the units of parallel work.
+  int split_depth = 2;
+  unsigned tt_size_log2 = 22;
+};
+
+struct SolveResult {
+  // From the point of view of the player to move.
+  GameValue value = GameValue::Draw;
+  std::optional<Position> best_move;
+  std::uint64_t nodes = 0;
+  std::size_t tasks = 0;
+  unsigned threads = 1;
+  std::chrono::microseconds elapsed{0};
+};
+
+// Computes the game-theoretic value of a position by exhaustive alpha-beta
+// search. All distinct positions split_depth moves below the root are solved
+// by a pool of threads that share one lock-free transposition table; the top
+// of the tree is then resolved from the table.
+class ParallelSolver {
+ public:
+  ParallelSolver(const GameRules& rules, SolverOptions options);
+
+  outcome::result<SolveResult> solve(const Engine& engine);
+
+  unsigned threads() const { return threads_; }
+
+ private:
+  GameRules rules_;
+  SolverOptions options_;
+  unsigned threads_;
+  ZobristKeys zobrist_;
+  SharedTranspositionTable tt_;
+  std::vector<int> cell_weights_;
+
+  struct Task {
+    Engine engine;
+    std::uint64_t hash;
+  };
+
+  // Per thread: the nodes it searched and one row of num_cells moves per
+  // ply, so that the workers never allocate.
+  struct SearchStack {
+    explicit SearchStack(const GameRules& rules);
+    std::span<int> row(int ply);
+
+    std::size_t num_cells;
+    std::vector<int> moves;
+    std::uint64_t nodes = 0;
+  };
+
+  int solve_node(Engine& engine, std::uint64_t hash, int alpha, int beta,
+                 int ply, SearchStack& stack);
+  void collect_tasks(Engine& engine, std::uint64_t hash, int depth, int ply,
+                     SearchStack& stack, std::vector<Task>& tasks) const;
+  std::span<int> ordered_moves(const Engine& engine, int first,
+                               std::span<int> row) const;
+  std::uint64_t hash_of(const Engine& engine) const;
+};
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_PARALLEL_SOLVER_H_
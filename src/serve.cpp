@@ -0,0 +1,122 @@
+#include <docopt/docopt.h>
+#include <fmt/format.h>
+
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <limits>
+#include <map>
+#include <outcome.hpp>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include "game_server.hpp"
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+namespace {
+
+constexpr auto USAGE =
+    R"(Headless tic-tac-toe game server.
+
+    Usage:
+      serve [options]
+
+    Options:
+      -h --help          Show this screen.
+      --bind=<addr>      IPv4 address to listen on [default: 127.0.0.1].
+      --port=<n>         TCP port, 0 picks a free one [default: 7878].
+      --threads=<n>      Event loop threads, 0 for one per core [default: 0].
+      --shards=<n>       Independently locked parts of the game table
+                         [default: 64].
+      --max-games=<n>    Games one connection may be in at once
+                         [default: 16].
+      --stats=<s>        Seconds between metric reports, 0 for none
+                         [default: 10].
+)";
+
+volatile std::sig_atomic_t stop_requested = 0;
+
+extern "C" void RequestStop(int /*signal*/) { stop_requested = 1; }
+
+outcome::result<long> ParseInRange(const docopt::value& value, long max) {
+  try {
+    const auto parsed = value.asLong();
+    if (parsed < 0 or parsed > max) {
+      return std::errc::argument_out_of_domain;
+    }
+    return parsed;
+  } catch (const std::exception&) {
+    return std::errc::invalid_argument;
+  }
+}
+
+outcome::result<tictactoe::ServerOptions> MakeOptions(
+    const std::map<std::string, docopt::value>& args) {
+  constexpr long kMaxInt = std::numeric_limits<int>::max();
+  tictactoe::ServerOptions options;
+  options.bind_address = args.at("--bind").asString();
+  options.port = static_cast<std::uint16_t>(OUTCOME_TRYX(ParseInRange(
+      args.at("--port"), std::numeric_limits<std::uint16_t>::max())));
+  options.threads = static_cast<unsigned>(
+      OUTCOME_TRYX(ParseInRange(args.at("--threads"), kMaxInt)));
+  options.shards = static_cast<unsigned>(
+      OUTCOME_TRYX(ParseInRange(args.at("--shards"), kMaxInt)));
+  options.max_games_per_connection = static_cast<std::size_t>(
+      OUTCOME_TRYX(ParseInRange(args.at("--max-games"), kMaxInt)));
+  return options;
+}
+
+}  // namespace
+
+// Hosts games for any number of clients until interrupted, e.g.
+//   serve --port=7878
+//   game --connect=localhost:7878
+int main(int argc, const char** argv) {
+  const auto args = docopt::docopt(USAGE, {argv + 1, argv + argc}, true);
+
+  const auto options = MakeOptions(args);
+  const auto stats_interval = ParseInRange(args.at("--stats"), 86400);
+  if (!options or !stats_interval) {
+    fmt::print(stderr, "invalid arguments\n");
+    return EXIT_FAILURE;
+  }
+
+  // a client hanging up must not take the server down
+  std::signal(SIGPIPE, SIG_IGN);
+  std::signal(SIGINT, RequestStop);
+  std::signal(SIGTERM, RequestStop);
+
+  auto server = tictactoe::GameServer::start(options.value());
+  if (!server) {
+    fmt::print(stderr, "starting the server failed: {}\n",
+               server.error().message());
+    return EXIT_FAILURE;
+  }
+  fmt::print("listening on {}:{}\n", options.value().bind_address,
+             server.value()->port());
+
+  const std::chrono::seconds interval{stats_interval.value()};
+  auto next_report = std::chrono::steady_clock::now() + interval;
+  while (stop_requested == 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    if (interval.count() > 0 and
+        std::chrono::steady_clock::now() >= next_report) {
+      next_report += interval;
+      const auto m = server.value()->metrics();
+      fmt::print(
+          "{} connections, {} games ({} created), {} moves, {:.0f} req/s, "
+          "latency p50 {:.1f} us p99 {:.1f} us\n",
+          m.connections, m.games_active, m.games_created, m.moves,
+          m.requests_per_second(), static_cast<double>(m.latency_p50_ns) / 1e3,
+          static_cast<double>(m.latency_p99_ns) / 1e3);
+    }
+  }
+
+  server.value()->stop();
+  fmt::print("stopped\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,161 @@
+#include <docopt/docopt.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <limits>
+#include <map>
+#include <optional>
+#include <outcome.hpp>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "batch_simulation.hpp"
+#include "game_record.hpp"
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+namespace {
+
+constexpr auto USAGE =
+    R"(Headless tic-tac-toe simulation.
+
+    Usage:
+      simulate [options]
+
+    Options:
+      -h --help          Show this screen.
+      --games=<n>        Number of games to play [default: 100000].
+      --size=<n>         Number of fields along each side [default: 3].
+      --rows=<n>         Number of rows, overrides --size.
+      --cols=<n>         Number of columns, overrides --size.
+      --win=<k>          Stones in a row needed to win; defaults to the
+                         shorter side of the board.
+      --players=<kind>   'random' moves or 'negamax' on both sides
+                         [default: random].
+      --opening=<n>      Random moves before negamax takes over [default: 2].
+      --ai-depth=<d>     Negamax search depth, 0 for unlimited [default: 3].
+      --ai-time=<ms>     Negamax thinking time per move [default: 1000].
+      --threads=<n>      Worker threads, 0 for one per core [default: 0].
+      --seed=<n>         Seed of the per-thread random generators [default: 1].
+      --record=<file>    Append every game to a game record file.
+)";
+
+outcome::result<long> ParseNonNegative(const docopt::value& value) {
+  try {
+    const auto parsed = value.asLong();
+    if (parsed < 0 or parsed > std::numeric_limits<int>::max()) {
+      return std::errc::argument_out_of_domain;
+    }
+    return parsed;
+  } catch (const std::exception&) {
+    return std::errc::invalid_argument;
+  }
+}
+
+outcome::result<int> ParseInt(const docopt::value& value) {
+  return static_cast<int>(OUTCOME_TRYX(ParseNonNegative(value)));
+}
+
+outcome::result<tictactoe::SimulationOptions> MakeOptions(
+    const std::map<std::string, docopt::value>& args) {
+  tictactoe::SimulationOptions options;
+  const int size = OUTCOME_TRYX(ParseInt(args.at("--size")));
+  options.rules.rows =
+      args.at("--rows") ? OUTCOME_TRYX(ParseInt(args.at("--rows"))) : size;
+  options.rules.cols =
+      args.at("--cols") ? OUTCOME_TRYX(ParseInt(args.at("--cols"))) : size;
+  options.rules.win_length =
+      args.at("--win") ? OUTCOME_TRYX(ParseInt(args.at("--win")))
+                       : std::min(options.rules.rows, options.rules.cols);
+
+  options.games = static_cast<std::uint64_t>(
+      OUTCOME_TRYX(ParseNonNegative(args.at("--games"))));
+  const auto& players = args.at("--players").asString();
+  if (players == "random") {
+    options.players = tictactoe::SimulatedPlayer::Random;
+  } else if (players == "negamax") {
+    options.players = tictactoe::SimulatedPlayer::Negamax;
+  } else {
+    return std::errc::invalid_argument;
+  }
+  options.random_opening_moves = OUTCOME_TRYX(ParseInt(args.at("--opening")));
+  options.search_limits.max_depth =
+      OUTCOME_TRYX(ParseInt(args.at("--ai-depth")));
+  options.search_limits.time_budget =
+      std::chrono::milliseconds{OUTCOME_TRYX(ParseInt(args.at("--ai-time")))};
+  options.threads =
+      static_cast<unsigned>(OUTCOME_TRYX(ParseInt(args.at("--threads"))));
+  options.seed = static_cast<std::uint64_t>(
+      OUTCOME_TRYX(ParseNonNegative(args.at("--seed"))));
+  return options;
+}
+
+double Percent(std::uint64_t part, std::uint64_t whole) {
+  return whole > 0 ? 100.0 * static_cast<double>(part) /
+                         static_cast<double>(whole)
+                   : 0.0;
+}
+
+}  // namespace
+
+// Plays many games without a window, e.g. to load-test rule changes:
+//   simulate --size=4 --games=1000000
+//   simulate --size=15 --win=5 --players=negamax --games=100 --ai-depth=2
+int main(int argc, const char** argv) {
+  const auto args = docopt::docopt(USAGE, {argv + 1, argv + argc}, true);
+
+  const auto options = MakeOptions(args);
+  if (!options) {
+    fmt::print(stderr, "invalid arguments: {}\n", options.error().message());
+    return EXIT_FAILURE;
+  }
+
+  // opened up front, so the games are streamed into it as they finish
+  std::optional<tictactoe::GameRecordWriter> records;
+  if (args.at("--record")) {
+    const auto& path = args.at("--record").asString();
+    auto opened =
+        tictactoe::GameRecordWriter::open(path, options.value().rules);
+    if (!opened) {
+      fmt::print(stderr, "cannot record to {}: {}\n", path,
+                 opened.error().message());
+      return EXIT_FAILURE;
+    }
+    records.emplace(std::move(opened).value());
+  }
+
+  const auto result = tictactoe::RunSimulation(
+      options.value(), records ? &*records : nullptr);
+  if (!result) {
+    fmt::print(stderr, "simulation failed: {}\n", result.error().message());
+    return EXIT_FAILURE;
+  }
+
+  const auto& r = result.value();
+  if (records) {
+    fmt::print("recorded {} games to {}\n", r.games,
+               args.at("--record").asString());
+  }
+  const auto& rules = options.value().rules;
+  fmt::print("{}x{} board, {} in a row, {} games on {} threads\n", rules.rows,
+             rules.cols, rules.win_length, r.games, r.threads);
+  fmt::print("cross wins:  {:>12} ({:.2f}%)\n", r.cross_wins,
+             Percent(r.cross_wins, r.games));
+  fmt::print("circle wins: {:>12} ({:.2f}%)\n", r.circle_wins,
+             Percent(r.circle_wins, r.games));
+  fmt::print("draws:       {:>12} ({:.2f}%)\n", r.draws,
+             Percent(r.draws, r.games));
+  fmt::print("moves/game:  {:>12.2f}\n",
+             r.games > 0 ? static_cast<double>(r.moves) /
+                               static_cast<double>(r.games)
+                         : 0.0);
+  fmt::print("time:        {:>12.3f} s ({:.0f} games/s)\n",
+             static_cast<double>(r.elapsed.count()) / 1e6,
+             r.games_per_second());
+  return EXIT_SUCCESS;
+}
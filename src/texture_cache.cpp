@@ -0,0 +1,102 @@
+#include "texture_cache.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+namespace tictactoe {
+
+namespace {
+// Texels of blank space kept between and after the marks in the atlas.
+constexpr unsigned kAtlasPadding = 2;
+
+double milliseconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+}  // namespace
+
+MarkAtlas::MarkAtlas(const std::filesystem::path& asset_dir)
+    : requested_{std::chrono::steady_clock::now()},
+      pending_{std::async(std::launch::async, &MarkAtlas::decode, asset_dir)} {}
+
+MarkAtlas::Decoded MarkAtlas::decode(const std::filesystem::path& asset_dir) {
+  const auto start = std::chrono::steady_clock::now();
+  sf::Image cross;
+  sf::Image circle;
+  if (!cross.loadFromFile((asset_dir / "cross.png").string()) or
+      !circle.loadFromFile((asset_dir / "circle.png").string())) {
+    spdlog::error("failed to load the mark textures from {}",
+                  asset_dir.string());
+  }
+
+  const auto cross_size = cross.getSize();
+  const auto circle_size = circle.getSize();
+  const unsigned circle_left = cross_size.x + kAtlasPadding;
+  const unsigned blank_left = circle_left + circle_size.x + kAtlasPadding;
+
+  Decoded decoded;
+  decoded.atlas.create(blank_left + kAtlasPadding,
+                       std::max({cross_size.y, circle_size.y, kAtlasPadding}),
+                       sf::Color::White);
+  decoded.atlas.copy(cross, 0, 0);
+  decoded.atlas.copy(circle, circle_left, 0);
+
+  decoded.cross_uv = sf::FloatRect{0.0f, 0.0f, static_cast<float>(cross_size.x),
+                                   static_cast<float>(cross_size.y)};
+  decoded.circle_uv = sf::FloatRect{static_cast<float>(circle_left), 0.0f,
+                                    static_cast<float>(circle_size.x),
+                                    static_cast<float>(circle_size.y)};
+  // A single texel in the middle of the blank strip; every corner samples it.
+  const float blank = static_cast<float>(blank_left) +
+                      static_cast<float>(kAtlasPadding) * 0.5f;
+  decoded.blank_uv = sf::FloatRect{blank, 0.5f, 0.0f, 0.0f};
+
+  spdlog::info("decoded the mark atlas in {:.1f} ms",
+               milliseconds_since(start));
+  return decoded;
+}
+
+bool MarkAtlas::ready() {
+  if (ready_) {
+    return true;
+  }
+  if (pending_.wait_for(std::chrono::seconds{0}) !=
+      std::future_status::ready) {
+    return false;
+  }
+
+  const auto upload_start = std::chrono::steady_clock::now();
+  const auto decoded = pending_.get();
+  texture_.loadFromImage(decoded.atlas);
+  cross_uv_ = decoded.cross_uv;
+  circle_uv_ = decoded.circle_uv;
+  blank_uv_ = decoded.blank_uv;
+
+  ready_ = true;
+  spdlog::info("uploaded the mark atlas in {:.1f} ms, {:.1f} ms after it was "
+               "requested",
+               milliseconds_since(upload_start),
+               milliseconds_since(requested_));
+  return true;
+}
+
+TextureCache& TextureCache::shared() {
+  static TextureCache cache;
+  return cache;
+}
+
+std::shared_ptr<MarkAtlas> TextureCache::mark_atlas(
+    const std::filesystem::path& asset_dir) {
+  std::lock_guard lock{mutex_};
+  auto& entry = atlases_[asset_dir];
+  auto atlas = entry.lock();
+  if (!atlas) {
+    atlas = std::make_shared<MarkAtlas>(asset_dir);
+    entry = atlas;
+  }
+  return atlas;
+}
+
+}  // namespace tictactoe
@@ -0,0 +1,70 @@
+#ifndef TICTACTOE_TEXTURE_CACHE_H_
+#define TICTACTOE_TEXTURE_CACHE_H_
+
+#include <SFML/Graphics.hpp>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace tictactoe {
+
+// One texture holding both marks, laid out left to right as cross, circle
+// and a blank white strip that untextured quads sample from. The images are
+// decoded on a background thread; the texture itself is created by ready(),
+// which has to be called from the thread owning the OpenGL context.
+class MarkAtlas {
+ public:
+  explicit MarkAtlas(const std::filesystem::path& asset_dir);
+
+  MarkAtlas(const MarkAtlas&) = delete;
+  MarkAtlas& operator=(const MarkAtlas&) = delete;
+
+  // Uploads the texture once decoding finished. Cheap to poll every frame.
+  bool ready();
+
+  const sf::Texture& texture() const { return texture_; }
+  const sf::FloatRect& cross_uv() const { return cross_uv_; }
+  const sf::FloatRect& circle_uv() const { return circle_uv_; }
+  const sf::FloatRect& blank_uv() const { return blank_uv_; }
+
+ private:
+  struct Decoded {
+    sf::Image atlas;
+    sf::FloatRect cross_uv;
+    sf::FloatRect circle_uv;
+    sf::FloatRect blank_uv;
+  };
+
+  static Decoded decode(const std::filesystem::path& asset_dir);
+
+  std::chrono::steady_clock::time_point requested_;
+  std::future<Decoded> pending_;
+  bool ready_ = false;
+  sf::Texture texture_;
+  sf::FloatRect cross_uv_;
+  sf::FloatRect circle_uv_;
+  sf::FloatRect blank_uv_;
+};
+
+// Hands out one MarkAtlas per asset directory to every grid asking for it.
+// Atlases are reference counted: the texture is freed with the last grid
+// using it and loaded again for the next one.
+class TextureCache {
+ public:
+  // The cache shared by all grids of the process.
+  static TextureCache& shared();
+
+  std::shared_ptr<MarkAtlas> mark_atlas(
+      const std::filesystem::path& asset_dir);
+
+ private:
+  std::mutex mutex_;
+  std::map<std::filesystem::path, std::weak_ptr<MarkAtlas>> atlases_;
+};
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_TEXTURE_CACHE_H_
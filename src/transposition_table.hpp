@@ -0,0 +1,96 @@
+#ifndef TICTACTOE_TRANSPOSITION_TABLE_H_
+#define TICTACTOE_TRANSPOSITION_TABLE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace tictactoe {
+
+enum class Bound : std::uint8_t {
+  Exact,
+  Lower,
+  Upper,
+};
+
+struct TTEntry {
+  std::uint64_t key = 0;
+  std::int32_t score = 0;
+  std::int32_t best_move = -1;
+  std::int16_t depth = -1;
+  Bound bound = Bound::Exact;
+};
+
+// Fixed-size, direct-mapped hash table of search results. On collision the
+// entry searched to the greater depth is kept.
+class TranspositionTable {
+  std::vector<TTEntry> entries_;
+  std::uint64_t mask_;
+
+ public:
+  explicit TranspositionTable(unsigned size_log2)
+      : entries_(std::size_t{1} << size_log2),
+        mask_{(std::uint64_t{1} << size_log2) - 1} {}
+
+  const TTEntry* probe(std::uint64_t key) const {
+    const auto& e = entries_[key & mask_];
+    return e.depth >= 0 and e.key == key ? &e : nullptr;
+  }
+
+  void store(const TTEntry& entry) {
+    auto& slot = entries_[entry.key & mask_];
+    if (slot.key == entry.key or entry.depth >= slot.depth) {
+      slot = entry;
+    }
+  }
+
+  void clear() { entries_.assign(entries_.size(), TTEntry{}); }
+
+  std::size_t size() const { return entries_.size(); }
+};
+
+// Transposition table shared between search threads without locking. Each
+// slot holds the payload and its xor with the key; a slot overwritten
+// concurrently by two threads fails the key check on probe and reads as a
+// miss instead of returning a torn entry. A payload of 0 marks an empty slot.
+class SharedTranspositionTable {
+  struct Slot {
+    std::atomic<std::uint64_t> check{0};
+    std::atomic<std::uint64_t> data{0};
+  };
+
+  std::size_t size_;
+  std::unique_ptr<Slot[]> slots_;
+  std::uint64_t mask_;
+
+ public:
+  explicit SharedTranspositionTable(unsigned size_log2)
+      : size_{std::size_t{1} << size_log2},
+        slots_{std::make_unique<Slot[]>(size_)},
+        mask_{(std::uint64_t{1} << size_log2) - 1} {}
+
+  std::optional<std::uint64_t> probe(std::uint64_t key) const {
+    const auto& slot = slots_[key & mask_];
+    const auto data = slot.data.load(std::memory_order_relaxed);
+    const auto check = slot.check.load(std::memory_order_relaxed);
+    if (data == 0 or (check ^ data) != key) {
+      return std::nullopt;
+    }
+    return data;
+  }
+
+  void store(std::uint64_t key, std::uint64_t data) {
+    auto& slot = slots_[key & mask_];
+    slot.check.store(key ^ data, std::memory_order_relaxed);
+    slot.data.store(data, std::memory_order_relaxed);
+  }
+
+  std::size_t size() const { return size_; }
+};
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_TRANSPOSITION_TABLE_H_
@@ -0,0 +1,50 @@
+#ifndef TICTACTOE_WIN_LINES_H_
+#define TICTACTOE_WIN_LINES_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "board.hpp"
+
+namespace tictactoe {
+
+// All segments of win_length consecutive cells (in any of the four
+// directions) that would win the game if filled by one player. Returned as
+// a flat list of cell indices, win_length entries per segment.
+inline std::vector<int> winning_segments(const GameRules& rules) {
+  constexpr int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+  const int k = rules.win_length;
+
+  std::vector<int> cells;
+  for (const auto& d : directions) {
+    for (int row = 0; row < rules.rows; ++row) {
+      for (int col = 0; col < rules.cols; ++col) {
+        const int end_row = row + d[0] * (k - 1);
+        const int end_col = col + d[1] * (k - 1);
+        if (end_row < 0 or end_row >= rules.rows or end_col < 0 or
+            end_col >= rules.cols) {
+          continue;
+        }
+        for (int i = 0; i < k; ++i) {
+          cells.push_back(static_cast<int>(
+              pos2idx(row + d[0] * i, col + d[1] * i, rules.cols)));
+        }
+      }
+    }
+  }
+  return cells;
+}
+
+// Number of winning segments each cell takes part in; a cheap static measure
+// of how valuable a cell is, used for move ordering.
+inline std::vector<int> segments_per_cell(const GameRules& rules) {
+  std::vector<int> counts(static_cast<std::size_t>(rules.num_cells()), 0);
+  for (const int cell : winning_segments(rules)) {
+    ++counts[static_cast<std::size_t>(cell)];
+  }
+  return counts;
+}
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_WIN_LINES_H_
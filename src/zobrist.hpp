@@ -0,0 +1,43 @@
+#ifndef TICTACTOE_ZOBRIST_H_
+#define TICTACTOE_ZOBRIST_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "board.hpp"
+
+namespace tictactoe {
+
+constexpr std::uint64_t splitmix64(std::uint64_t& state) {
+  std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27U)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31U);
+}
+
+// Random 64-bit key for every (cell, player) pair. The hash of a position is
+// the xor of the keys of all occupied cells, so it can be updated in O(1) per
+// move. The side to move follows from the number of stones and needs no key.
+class ZobristKeys {
+  std::vector<std::uint64_t> keys_;
+
+ public:
+  explicit ZobristKeys(std::size_t num_cells,
+                       std::uint64_t seed = 0x5EED'7AC7'0E5ULL)
+      : keys_(2 * num_cells) {
+    for (auto& k : keys_) {
+      k = splitmix64(seed);
+    }
+  }
+
+  std::uint64_t key(std::size_t cell, Player p) const {
+    return keys_[2 * cell + (p == Player::CirclePlayer ? 0 : 1)];
+  }
+
+  std::size_t num_cells() const { return keys_.size() / 2; }
+};
+
+}  // namespace tictactoe
+
+#endif  // TICTACTOE_ZOBRIST_H_
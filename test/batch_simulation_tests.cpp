@@ -0,0 +1,59 @@
+#include <catch2/catch.hpp>
+
+#include "batch_simulation.hpp"
+
+using tictactoe::GameRules;
+using tictactoe::RunSimulation;
+using tictactoe::SimulatedPlayer;
+using tictactoe::SimulationOptions;
+
+namespace {
+SimulationOptions random_games(std::uint64_t games, unsigned threads)
+{
+  SimulationOptions options;
+  options.rules = GameRules::square(3);
+  options.games = games;
+  options.threads = threads;
+  return options;
+}
+}// namespace
+
+TEST_CASE("Every simulated game ends in exactly one outcome", "[simulation]")
+{
+  const auto threads = GENERATE(1U, 3U);
+  const auto result = RunSimulation(random_games(1000, threads)).value();
+  REQUIRE(result.games == 1000);
+  REQUIRE(result.threads == threads);
+  REQUIRE(result.cross_wins + result.circle_wins + result.draws == 1000);
+  // a 3x3 game takes between 5 and 9 moves
+  REQUIRE(result.moves >= 5 * result.games);
+  REQUIRE(result.moves <= 9 * result.games);
+  // the first player wins most random games
+  REQUIRE(result.cross_wins > result.circle_wins);
+}
+
+TEST_CASE("Simulations are reproducible from the seed", "[simulation]")
+{
+  const auto first = RunSimulation(random_games(500, 2)).value();
+  const auto second = RunSimulation(random_games(500, 2)).value();
+  REQUIRE(first.cross_wins == second.cross_wins);
+  REQUIRE(first.circle_wins == second.circle_wins);
+  REQUIRE(first.moves == second.moves);
+}
+
+TEST_CASE("Perfect players always draw on 3x3", "[simulation]")
+{
+  auto options = random_games(4, 2);
+  options.players = SimulatedPlayer::Negamax;
+  options.random_opening_moves = 0;
+  options.search_limits.max_depth = 0;
+  const auto result = RunSimulation(options).value();
+  REQUIRE(result.draws == 4);
+}
+
+TEST_CASE("Simulation rejects invalid rules", "[simulation]")
+{
+  auto options = random_games(1, 1);
+  options.rules = GameRules{ 3, 3, 4 };
+  REQUIRE_FALSE(RunSimulation(options));
+}
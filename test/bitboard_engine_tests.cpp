@@ -0,0 +1,123 @@
+#include <catch2/catch.hpp>
+
+#include <utility>
+#include <vector>
+
+#include "bitboard_engine.hpp"
+
+using tictactoe::BasicEngine;
+using tictactoe::FieldState;
+using tictactoe::Player;
+using tictactoe::Position;
+
+namespace {
+using Moves = std::vector<std::pair<int, int>>;
+
+// A new game with the (row, col) moves played, alternating from X.
+template<typename EngineT> EngineT play(const Moves &moves)
+{
+  auto engine = EngineT::create_engine().value();
+  for (const auto &[row, col] : moves) {
+    const auto pos = Position::create_position_for_engine(row, col, engine).value();
+    REQUIRE(engine.handle_field_selected(pos));
+  }
+  return engine;
+}
+
+// X takes the cells of line one by one, O answers with the cells of other.
+Moves interleave(const Moves &line, const Moves &other)
+{
+  Moves moves;
+  for (std::size_t i = 0; i < line.size(); ++i) {
+    moves.push_back(line[i]);
+    if (i < other.size()) { moves.push_back(other[i]); }
+  }
+  return moves;
+}
+
+// Checks the game is undecided until the last of moves completes a line.
+template<typename EngineT> void require_decided_by_last(const Moves &moves, Player winner)
+{
+  const auto before = play<EngineT>(Moves{ moves.begin(), moves.end() - 1 });
+  REQUIRE_FALSE(before.maybe_winner());
+  REQUIRE_FALSE(before.maybe_get_winner());
+
+  const auto engine = play<EngineT>(moves);
+  REQUIRE(engine.maybe_winner() == winner);
+  REQUIRE(engine.maybe_get_winner() == winner);
+}
+}// namespace
+
+TEMPLATE_TEST_CASE("Bitboard players alternate starting with cross", "[bitboard]", BasicEngine<3>, BasicEngine<8>, BasicEngine<9>)
+{
+  const auto engine = play<TestType>({ { 0, 0 }, { 1, 1 } });
+  const auto first = Position::create_position_for_engine(0, 0, engine).value();
+  const auto second = Position::create_position_for_engine(1, 1, engine).value();
+  REQUIRE(engine.get_field_state_at(first) == FieldState::Cross);
+  REQUIRE(engine.get_field_state_at(second) == FieldState::Circle);
+  REQUIRE(engine.get_active_player() == Player::CrossPlayer);
+}
+
+TEMPLATE_TEST_CASE("Bitboard occupied fields cannot be selected again", "[bitboard]", BasicEngine<3>, BasicEngine<8>, BasicEngine<9>)
+{
+  auto engine = play<TestType>({ { 0, 0 } });
+  const auto pos = Position::create_position_for_engine(0, 0, engine).value();
+  REQUIRE_FALSE(engine.handle_field_selected(pos));
+  REQUIRE(engine.get_field_state_at(pos) == FieldState::Cross);
+  REQUIRE(engine.get_active_player() == Player::CirclePlayer);
+}
+
+TEMPLATE_TEST_CASE("Bitboard completing a line decides the winner", "[bitboard]", BasicEngine<3>, BasicEngine<8>, BasicEngine<9>)
+{
+  constexpr int n = TestType{}.board_size();
+  Moves row;
+  Moves column;
+  Moves diagonal;
+  Moves antidiagonal;
+  Moves top_row;
+  Moves bottom_row;
+  for (int i = 0; i < n; ++i) {
+    row.emplace_back(1, i);
+    column.emplace_back(i, n - 1);
+    diagonal.emplace_back(i, i);
+    antidiagonal.emplace_back(i, n - 1 - i);
+    top_row.emplace_back(0, i);
+    bottom_row.emplace_back(n - 1, i);
+  }
+
+  SECTION("row")
+  {
+    require_decided_by_last<TestType>(interleave(row, Moves{ top_row.begin(), top_row.end() - 1 }), Player::CrossPlayer);
+  }
+  SECTION("column")
+  {
+    // X stays one short of the first column, then O completes the last
+    Moves first_column;
+    for (int i = 0; i + 1 < n; ++i) { first_column.emplace_back(i, 0); }
+    first_column.emplace_back(n - 1, 1);
+    require_decided_by_last<TestType>(interleave(first_column, column), Player::CirclePlayer);
+  }
+  SECTION("diagonal")
+  {
+    require_decided_by_last<TestType>(interleave(diagonal, Moves{ top_row.begin() + 1, top_row.end() }), Player::CrossPlayer);
+  }
+  SECTION("antidiagonal")
+  {
+    require_decided_by_last<TestType>(interleave(antidiagonal, Moves{ bottom_row.begin() + 1, bottom_row.end() }), Player::CrossPlayer);
+  }
+}
+
+TEMPLATE_TEST_CASE("Bitboard moves after the game is won are ignored", "[bitboard]", BasicEngine<3>, BasicEngine<8>)
+{
+  constexpr int n = TestType{}.board_size();
+  Moves moves;
+  for (int i = 0; i < n; ++i) {
+    moves.emplace_back(1, i);
+    if (i + 1 < n) { moves.emplace_back(0, i); }
+  }
+  auto engine = play<TestType>(moves);
+  const auto pos = Position::create_position_for_engine(n - 1, n - 1, engine).value();
+  REQUIRE(engine.handle_field_selected(pos));
+  REQUIRE(engine.get_field_state_at(pos) == FieldState::Empty);
+  REQUIRE(engine.maybe_winner() == Player::CrossPlayer);
+}
@@ -0,0 +1,105 @@
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <vector>
+
+#include "board_batch.hpp"
+#include "engine.hpp"
+
+using tictactoe::BoardBatch;
+using tictactoe::BoardStatus;
+using tictactoe::Engine;
+using tictactoe::FieldState;
+using tictactoe::GameRules;
+using tictactoe::Player;
+using tictactoe::Position;
+using tictactoe::SimdLevel;
+
+namespace {
+// Plays random moves until the game ends or, half of the time, earlier.
+Engine random_game(const GameRules& rules, std::mt19937& rng)
+{
+  auto engine = Engine::create_engine(rules).value();
+  const int stop_after = static_cast<int>(rng() % 2) == 0
+                           ? rules.num_cells()
+                           : static_cast<int>(rng() % static_cast<unsigned>(rules.num_cells()));
+  for (int moves = 0; moves < stop_after and !engine.maybe_winner(); ++moves) {
+    Position pos = Position::create_position_for_engine(0, 0, engine).value();
+    do {
+      const int cell = static_cast<int>(rng() % static_cast<unsigned>(rules.num_cells()));
+      pos = Position::create_position_for_engine(cell / rules.cols, cell % rules.cols, engine).value();
+    } while (engine.get_field_state_at(pos) != FieldState::Empty);
+    REQUIRE(engine.handle_field_selected(pos));
+  }
+  return engine;
+}
+
+BoardStatus status_of(const Engine& engine)
+{
+  if (const auto winner = engine.maybe_get_winner()) {
+    return *winner == Player::CrossPlayer ? BoardStatus::CrossWon : BoardStatus::CircleWon;
+  }
+  return engine.move_history().size() == static_cast<std::size_t>(engine.rules().num_cells())
+           ? BoardStatus::Draw
+           : BoardStatus::Ongoing;
+}
+}// namespace
+
+TEST_CASE("Batch evaluation agrees with the engine", "[board_batch]")
+{
+  const auto rules = GENERATE(GameRules::square(3), GameRules::square(4), GameRules{ 6, 7, 4 }, GameRules{ 15, 15, 5 });
+  const auto level = GENERATE(SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2);
+  // not a multiple of any vector width
+  constexpr std::size_t kBoards = 1003;
+
+  std::mt19937 rng{ 7 };
+  BoardBatch batch{ rules, kBoards };
+  std::vector<BoardStatus> expected;
+  for (std::size_t board = 0; board < kBoards; ++board) {
+    const auto engine = random_game(rules, rng);
+    batch.store(board, engine);
+    expected.push_back(status_of(engine));
+  }
+
+  std::vector<BoardStatus> statuses(kBoards, BoardStatus::Invalid);
+  evaluate(batch, statuses, level);
+  REQUIRE(statuses == expected);
+}
+
+TEST_CASE("Boards with winning lines for both players are invalid", "[board_batch]")
+{
+  BoardBatch batch{ GameRules::square(3), 2 };
+  for (int col = 0; col < 3; ++col) {
+    batch.set(0, col, FieldState::Cross);
+    batch.set(0, 6 + col, FieldState::Circle);
+    batch.set(1, 3 + col, FieldState::Circle);
+  }
+
+  std::vector<BoardStatus> statuses(2);
+  evaluate(batch, statuses);
+  REQUIRE(statuses[0] == BoardStatus::Invalid);
+  REQUIRE(statuses[1] == BoardStatus::CircleWon);
+}
+
+TEST_CASE("Every SIMD level classifies arbitrary boards alike", "[board_batch]")
+{
+  const GameRules rules{ 8, 8, 5 };
+  constexpr std::size_t kBoards = 517;
+  std::mt19937 rng{ 11 };
+  BoardBatch batch{ rules, kBoards };
+  for (std::size_t board = 0; board < kBoards; ++board) {
+    for (int cell = 0; cell < rules.num_cells(); ++cell) {
+      // stones of both colours, so some boards are invalid as well
+      const auto roll = rng() % 4;
+      batch.set(board, cell, roll == 0 ? FieldState::Empty : roll % 2 == 0 ? FieldState::Cross : FieldState::Circle);
+    }
+  }
+
+  std::vector<BoardStatus> scalar(kBoards);
+  evaluate(batch, scalar, SimdLevel::Scalar);
+  for (const auto level : { SimdLevel::Sse2, SimdLevel::Avx2 }) {
+    std::vector<BoardStatus> vectorised(kBoards);
+    evaluate(batch, vectorised, level);
+    REQUIRE(vectorised == scalar);
+  }
+}
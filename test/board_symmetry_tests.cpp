@@ -0,0 +1,105 @@
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <set>
+#include <vector>
+
+#include "board_symmetry.hpp"
+
+using tictactoe::BoardSymmetry;
+using tictactoe::FieldState;
+
+namespace {
+std::vector<FieldState> random_board(int cells, std::mt19937 &rng)
+{
+  std::vector<FieldState> board;
+  for (int i = 0; i < cells; ++i) { board.push_back(static_cast<FieldState>(std::uniform_int_distribution<int>{ 0, 2 }(rng))); }
+  return board;
+}
+
+std::vector<FieldState> apply(const BoardSymmetry &symmetry, int t, const std::vector<FieldState> &board)
+{
+  std::vector<FieldState> result(board.size());
+  for (int cell = 0; cell < symmetry.num_cells(); ++cell) {
+    result[static_cast<std::size_t>(symmetry.map_cell(t, cell))] = board[static_cast<std::size_t>(cell)];
+  }
+  return result;
+}
+}// namespace
+
+TEST_CASE("Transforms are distinct permutations with inverses", "[symmetry]")
+{
+  const int size = GENERATE(2, 3, 4, 7);
+  const BoardSymmetry symmetry{ size };
+  std::set<std::vector<int>> permutations;
+  for (int t = 0; t < BoardSymmetry::kNumTransforms; ++t) {
+    std::vector<int> permutation;
+    for (int cell = 0; cell < symmetry.num_cells(); ++cell) {
+      permutation.push_back(symmetry.map_cell(t, cell));
+      REQUIRE(symmetry.unmap_cell(t, symmetry.map_cell(t, cell)) == cell);
+      if (t == 0) { REQUIRE(symmetry.map_cell(t, cell) == cell); }
+    }
+    REQUIRE(std::set<int>(permutation.begin(), permutation.end()).size() == permutation.size());
+    permutations.insert(permutation);
+  }
+  REQUIRE(permutations.size() == 8);
+}
+
+TEST_CASE("Transform 1 rotates clockwise", "[symmetry]")
+{
+  const BoardSymmetry symmetry{ 3 };
+  // top left corner goes to the top right, top right to the bottom right
+  REQUIRE(symmetry.map_cell(1, 0) == 2);
+  REQUIRE(symmetry.map_cell(1, 2) == 8);
+  REQUIRE(symmetry.map_cell(1, 4) == 4);
+}
+
+TEST_CASE("All orientations of a board share one canonical form", "[symmetry]")
+{
+  std::mt19937 rng{ 3 };
+  const int size = GENERATE(3, 4, 5, 9);
+  const BoardSymmetry symmetry{ size };
+  for (int trial = 0; trial < 20; ++trial) {
+    const auto board = random_board(symmetry.num_cells(), rng);
+    const auto canonical = symmetry.canonicalize(board);
+    REQUIRE(apply(symmetry, canonical.transform, board) == canonical.fields);
+
+    for (int t = 0; t < BoardSymmetry::kNumTransforms; ++t) {
+      const auto rotated = apply(symmetry, t, board);
+      REQUIRE(symmetry.canonicalize(rotated).fields == canonical.fields);
+      REQUIRE(rotated >= canonical.fields);
+    }
+
+    // the transform maps canonical cells back to the original board
+    for (int cell = 0; cell < symmetry.num_cells(); ++cell) {
+      const auto original = symmetry.unmap_cell(canonical.transform, cell);
+      REQUIRE(board[static_cast<std::size_t>(original)] == canonical.fields[static_cast<std::size_t>(cell)]);
+    }
+  }
+}
+
+TEST_CASE("Packed boards canonicalise like unpacked ones", "[symmetry]")
+{
+  std::mt19937 rng{ 5 };
+  const int size = GENERATE(2, 3, 4, 5);
+  const BoardSymmetry symmetry{ size };
+  for (int trial = 0; trial < 50; ++trial) {
+    const auto board = random_board(symmetry.num_cells(), rng);
+    const auto canonical = symmetry.canonicalize(board);
+    const auto packed = symmetry.canonicalize_packed(symmetry.pack(board));
+    REQUIRE(packed.key == symmetry.pack(canonical.fields));
+    for (int t = 0; t < BoardSymmetry::kNumTransforms; ++t) {
+      REQUIRE(symmetry.transform_packed(t, symmetry.pack(board)) == symmetry.pack(apply(symmetry, t, board)));
+    }
+  }
+}
+
+TEST_CASE("Engines are canonicalised from their fields", "[symmetry]")
+{
+  auto engine = tictactoe::Engine::create_engine(3).value();
+  REQUIRE(engine.handle_field_selected(tictactoe::Position::create_position_for_engine(2, 2, engine).value()));
+  const auto canonical = BoardSymmetry{ 3 }.canonicalize(engine);
+  // the lone cross ends up in the last cell
+  REQUIRE(canonical.fields.back() == FieldState::Cross);
+  REQUIRE(BoardSymmetry{ 3 }.unmap_cell(canonical.transform, 8) == 8);
+}
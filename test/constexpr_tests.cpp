@@ -12,3 +12,96 @@ TEST_CASE("Factorials are computed with constexpr", "[factorial]")
   STATIC_REQUIRE(Factorial(3) == 6);
   STATIC_REQUIRE(Factorial(10) == 3628800);
 }
+
+#include "bitboard_engine.hpp"
+
+using tictactoe::line_masks;
+
+TEST_CASE("Bitboard line masks cover whole rows, columns and diagonals",
+  "[bitboard]")
+{
+  constexpr auto &masks = line_masks<3>;
+  STATIC_REQUIRE(masks.size() == 8);
+  STATIC_REQUIRE(masks[0].words[0] == 0b000'000'111);
+  STATIC_REQUIRE(masks[2].words[0] == 0b111'000'000);
+  STATIC_REQUIRE(masks[3].words[0] == 0b001'001'001);
+  STATIC_REQUIRE(masks[5].words[0] == 0b100'100'100);
+  STATIC_REQUIRE(masks[6].words[0] == 0b100'010'001);
+  STATIC_REQUIRE(masks[7].words[0] == 0b001'010'100);
+}
+
+template<int N> constexpr bool all_masks_have_n_cells()
+{
+  for (const auto &mask : line_masks<N>) {
+    if (mask.count() != static_cast<std::size_t>(N)) { return false; }
+  }
+  return true;
+}
+
+TEST_CASE("Every bitboard line mask has exactly N cells", "[bitboard]")
+{
+  STATIC_REQUIRE(all_masks_have_n_cells<2>());
+  STATIC_REQUIRE(all_masks_have_n_cells<3>());
+  STATIC_REQUIRE(all_masks_have_n_cells<8>());
+  STATIC_REQUIRE(all_masks_have_n_cells<9>());
+  STATIC_REQUIRE(all_masks_have_n_cells<16>());
+}
+
+TEST_CASE("Bitboard line masks span word boundaries for large boards",
+  "[bitboard]")
+{
+  STATIC_REQUIRE(tictactoe::Bitboard<8>::num_words == 1);
+  STATIC_REQUIRE(tictactoe::Bitboard<9>::num_words == 2);
+
+  // last row of a 9x9 board occupies cells 72..80, all in the second word
+  constexpr auto &last_row = line_masks<9>[8];
+  STATIC_REQUIRE(last_row.words[0] == 0);
+  STATIC_REQUIRE(last_row.words[1] == 0b1'1111'1111ULL << 8U);
+
+  // the antidiagonal of a 9x9 board has cells in both words
+  constexpr auto &anti = line_masks<9>[19];
+  STATIC_REQUIRE(anti.test(8));
+  STATIC_REQUIRE(anti.test(72));
+  STATIC_REQUIRE(!anti.test(80));
+}
+
+#include "grid_layout.hpp"
+
+using tictactoe::GridLayout;
+
+TEST_CASE("Clicks are mapped to fields arithmetically", "[grid]")
+{
+  // fields start at 1, 12, 23, ... and are 10 units wide
+  STATIC_REQUIRE(GridLayout::field_at(1.0f, 1.0f, 3, 3) == std::tuple{ 0, 0 });
+  STATIC_REQUIRE(GridLayout::field_at(10.9f, 23.5f, 3, 3) == std::tuple{ 2, 0 });
+  STATIC_REQUIRE(GridLayout::field_at(30.0f, 15.0f, 3, 4) == std::tuple{ 1, 2 });
+  STATIC_REQUIRE(GridLayout::field_at(1000.5f, 1.5f, 1, 100) == std::tuple{ 0, 90 });
+}
+
+TEST_CASE("Clicks in the gaps or outside the board hit nothing", "[grid]")
+{
+  STATIC_REQUIRE(!GridLayout::field_at(0.5f, 5.0f, 3, 3));
+  STATIC_REQUIRE(!GridLayout::field_at(11.0f, 5.0f, 3, 3));
+  STATIC_REQUIRE(!GridLayout::field_at(5.0f, 11.5f, 3, 3));
+  STATIC_REQUIRE(!GridLayout::field_at(33.5f, 5.0f, 3, 3));
+  STATIC_REQUIRE(!GridLayout::field_at(5.0f, -3.0f, 3, 3));
+  STATIC_REQUIRE(!GridLayout::field_at(35.0f, 5.0f, 3, 3));
+  STATIC_REQUIRE(!GridLayout::field_at(1e30f, 5.0f, 3, 3));
+}
+
+TEST_CASE("Only fields overlapping the view are visible", "[grid]")
+{
+  // fields start at 1, 12, 23, ... and are 10 units wide
+  STATIC_REQUIRE(GridLayout::visible_fields(0.0f, 34.0f, 3) == std::pair{ 0, 3 });
+  STATIC_REQUIRE(GridLayout::visible_fields(-1e30f, 1e30f, 3) == std::pair{ 0, 3 });
+  STATIC_REQUIRE(GridLayout::visible_fields(12.5f, 22.5f, 100) == std::pair{ 1, 2 });
+  STATIC_REQUIRE(GridLayout::visible_fields(11.5f, 23.5f, 100) == std::pair{ 1, 3 });
+  STATIC_REQUIRE(GridLayout::visible_fields(10.5f, 11.5f, 100) == std::pair{ 0, 1 });
+}
+
+TEST_CASE("Nothing is visible outside the board", "[grid]")
+{
+  STATIC_REQUIRE(GridLayout::visible_fields(-20.0f, 0.5f, 3).first ==
+                 GridLayout::visible_fields(-20.0f, 0.5f, 3).second);
+  STATIC_REQUIRE(GridLayout::visible_fields(34.0f, 50.0f, 3) == std::pair{ 3, 3 });
+}
@@ -0,0 +1,198 @@
+#include <catch2/catch.hpp>
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "engine.hpp"
+#include "play_moves.hpp"
+
+using tictactoe::Engine;
+using tictactoe::FieldState;
+using tictactoe::Player;
+using tictactoe::Position;
+
+using tictactoe::test::play;
+
+namespace {
+constexpr tictactoe::GameRules kGomoku{ 15, 15, 5 };
+}// namespace
+
+TEST_CASE("Engine rejects boards smaller than 2x2", "[engine]")
+{
+  REQUIRE_FALSE(Engine::create_engine(1));
+  REQUIRE_FALSE(Engine::create_engine(0));
+  REQUIRE(Engine::create_engine(2));
+  REQUIRE(Engine::create_engine(4).value().board_size() == 4);
+}
+
+TEST_CASE("Positions are validated against the engine", "[engine]")
+{
+  const auto engine = Engine::create_engine(3).value();
+  REQUIRE(Position::create_position_for_engine(2, 2, engine));
+  REQUIRE_FALSE(Position::create_position_for_engine(3, 0, engine));
+  REQUIRE_FALSE(Position::create_position_for_engine(0, -1, engine));
+}
+
+TEST_CASE("Players alternate starting with cross", "[engine]")
+{
+  auto engine = play(3, { { 0, 0 }, { 1, 1 } });
+  const auto first = Position::create_position_for_engine(0, 0, engine).value();
+  const auto second = Position::create_position_for_engine(1, 1, engine).value();
+  REQUIRE(engine.get_field_state_at(first) == FieldState::Cross);
+  REQUIRE(engine.get_field_state_at(second) == FieldState::Circle);
+  REQUIRE(engine.get_active_player() == Player::CrossPlayer);
+}
+
+TEST_CASE("Occupied fields cannot be selected again", "[engine]")
+{
+  auto engine = play(3, { { 0, 0 } });
+  const auto pos = Position::create_position_for_engine(0, 0, engine).value();
+  REQUIRE_FALSE(engine.handle_field_selected(pos));
+  REQUIRE(engine.get_active_player() == Player::CirclePlayer);
+}
+
+TEST_CASE("Completing a line decides the winner", "[engine]")
+{
+  SECTION("row")
+  {
+    const auto engine = play(3, { { 1, 0 }, { 0, 0 }, { 1, 1 }, { 0, 1 }, { 1, 2 } });
+    REQUIRE(engine.maybe_winner() == Player::CrossPlayer);
+  }
+  SECTION("column")
+  {
+    const auto engine = play(3, { { 0, 0 }, { 0, 2 }, { 1, 1 }, { 1, 2 }, { 0, 1 }, { 2, 2 } });
+    REQUIRE(engine.maybe_winner() == Player::CirclePlayer);
+  }
+  SECTION("diagonal")
+  {
+    const auto engine = play(4, { { 0, 0 }, { 0, 1 }, { 1, 1 }, { 0, 2 }, { 2, 2 }, { 0, 3 }, { 3, 3 } });
+    REQUIRE(engine.maybe_winner() == Player::CrossPlayer);
+  }
+  SECTION("antidiagonal")
+  {
+    const auto engine = play(3, { { 0, 2 }, { 0, 0 }, { 1, 1 }, { 0, 1 }, { 2, 0 } });
+    REQUIRE(engine.maybe_winner() == Player::CrossPlayer);
+  }
+  SECTION("no line yet")
+  {
+    const auto engine = play(3, { { 0, 0 }, { 1, 1 }, { 0, 1 } });
+    REQUIRE_FALSE(engine.maybe_winner());
+    REQUIRE_FALSE(engine.maybe_get_winner());
+  }
+}
+
+TEST_CASE("Moves after the game is won are ignored", "[engine]")
+{
+  auto engine = play(3, { { 1, 0 }, { 0, 0 }, { 1, 1 }, { 0, 1 }, { 1, 2 } });
+  const auto pos = Position::create_position_for_engine(2, 2, engine).value();
+  REQUIRE(engine.handle_field_selected(pos));
+  REQUIRE(engine.get_field_state_at(pos) == FieldState::Empty);
+}
+
+TEST_CASE("Engine validates m,n,k rules", "[engine][mnk]")
+{
+  REQUIRE(Engine::create_engine(tictactoe::GameRules{ 3, 5, 3 }));
+  REQUIRE(Engine::create_engine(tictactoe::GameRules{ 1, 5, 4 }));
+  REQUIRE_FALSE(Engine::create_engine(tictactoe::GameRules{ 3, 3, 4 }));
+  REQUIRE_FALSE(Engine::create_engine(tictactoe::GameRules{ 3, 0, 2 }));
+  REQUIRE_FALSE(Engine::create_engine(tictactoe::GameRules{ 3, 3, 1 }));
+  // more cells than an int can count
+  REQUIRE_FALSE(Engine::create_engine(tictactoe::GameRules{ 65536, 65536, 5 }));
+  REQUIRE_FALSE(Engine::create_engine(tictactoe::GameRules{ std::numeric_limits<int>::max(), 2, 2 }));
+}
+
+TEST_CASE("Positions respect non-square board bounds", "[engine][mnk]")
+{
+  const auto engine = Engine::create_engine(tictactoe::GameRules{ 2, 4, 2 }).value();
+  REQUIRE(Position::create_position_for_engine(1, 3, engine));
+  REQUIRE_FALSE(Position::create_position_for_engine(2, 0, engine));
+  REQUIRE_FALSE(Position::create_position_for_engine(0, 4, engine));
+}
+
+TEST_CASE("Five in a row wins on a gomoku board", "[engine][mnk]")
+{
+  SECTION("row in the middle of the board")
+  {
+    const auto engine = play(kGomoku,
+      { { 7, 3 }, { 0, 0 }, { 7, 4 }, { 0, 1 }, { 7, 6 }, { 0, 2 }, { 7, 7 }, { 0, 3 }, { 7, 5 } });
+    REQUIRE(engine.maybe_winner() == Player::CrossPlayer);
+    REQUIRE(engine.maybe_get_winner() == Player::CrossPlayer);
+  }
+  SECTION("off-centre antidiagonal")
+  {
+    const auto engine = play(kGomoku,
+      { { 0, 0 }, { 2, 10 }, { 0, 1 }, { 3, 9 }, { 0, 2 }, { 4, 8 }, { 14, 14 }, { 5, 7 }, { 13, 14 }, { 6, 6 } });
+    REQUIRE(engine.maybe_winner() == Player::CirclePlayer);
+  }
+  SECTION("four in a row is not enough")
+  {
+    const auto engine = play(kGomoku, { { 7, 3 }, { 0, 0 }, { 7, 4 }, { 0, 1 }, { 7, 5 }, { 0, 2 }, { 7, 6 } });
+    REQUIRE_FALSE(engine.maybe_winner());
+    REQUIRE_FALSE(engine.maybe_get_winner());
+  }
+  SECTION("a gap breaks the run")
+  {
+    const auto engine = play(kGomoku,
+      { { 7, 3 }, { 0, 0 }, { 7, 4 }, { 0, 1 }, { 7, 6 }, { 0, 2 }, { 7, 7 }, { 7, 5 }, { 7, 8 } });
+    REQUIRE_FALSE(engine.maybe_winner());
+  }
+}
+
+TEST_CASE("Columns win on a non-square board", "[engine][mnk]")
+{
+  const auto engine = play(tictactoe::GameRules{ 3, 5, 3 },
+    { { 0, 4 }, { 0, 0 }, { 1, 4 }, { 0, 1 }, { 2, 4 } });
+  REQUIRE(engine.maybe_winner() == Player::CrossPlayer);
+  REQUIRE(engine.maybe_winner_for_column(4) == Player::CrossPlayer);
+}
+
+TEST_CASE("Unmaking moves restores the previous position", "[engine][undo]")
+{
+  const std::vector<std::pair<int, int>> moves = { { 1, 0 }, { 0, 0 }, { 1, 1 }, { 0, 1 }, { 1, 2 } };
+  auto engine = play(3, moves);
+  REQUIRE(engine.maybe_winner() == Player::CrossPlayer);
+  REQUIRE(engine.move_history().size() == 5);
+
+  engine.unmake_move();
+  REQUIRE_FALSE(engine.maybe_winner());
+  REQUIRE(engine.get_active_player() == Player::CrossPlayer);
+  REQUIRE(engine.get_field_state_at(Position::create_position_for_engine(1, 2, engine).value()) == FieldState::Empty);
+
+  // the line counters were restored too, so the win can be made again
+  REQUIRE(engine.handle_field_selected(Position::create_position_for_engine(1, 2, engine).value()));
+  REQUIRE(engine.maybe_winner() == Player::CrossPlayer);
+
+  while (!engine.move_history().empty()) { engine.unmake_move(); }
+  REQUIRE(engine.get_active_player() == Player::CrossPlayer);
+  REQUIRE_FALSE(engine.maybe_get_winner());
+}
+
+TEST_CASE("Unmaking works without line counters", "[engine][undo][mnk]")
+{
+  auto engine = play(kGomoku, { { 7, 3 }, { 0, 0 }, { 7, 4 }, { 0, 1 }, { 7, 6 }, { 0, 2 }, { 7, 7 }, { 0, 3 }, { 7, 5 } });
+  REQUIRE(engine.maybe_winner() == Player::CrossPlayer);
+  engine.unmake_move();
+  REQUIRE_FALSE(engine.maybe_winner());
+  REQUIRE(engine.get_active_player() == Player::CrossPlayer);
+}
+
+TEST_CASE("Undone moves can be redone until a new move is made", "[engine][undo]")
+{
+  auto engine = play(3, { { 0, 0 }, { 1, 1 } });
+  REQUIRE_FALSE(engine.can_redo());
+  REQUIRE(engine.undo());
+  REQUIRE(engine.undo());
+  REQUIRE_FALSE(engine.can_undo());
+  REQUIRE_FALSE(engine.undo());
+
+  REQUIRE(engine.redo());
+  REQUIRE(engine.get_field_state_at(Position::create_position_for_engine(0, 0, engine).value()) == FieldState::Cross);
+  REQUIRE(engine.get_active_player() == Player::CirclePlayer);
+  REQUIRE(engine.can_redo());
+
+  REQUIRE(engine.handle_field_selected(Position::create_position_for_engine(2, 2, engine).value()));
+  REQUIRE_FALSE(engine.can_redo());
+  REQUIRE_FALSE(engine.redo());
+  REQUIRE(engine.move_history() == std::vector<int>{ 0, 8 });
+}
@@ -0,0 +1,79 @@
+#include <catch2/catch.hpp>
+
+#include <variant>
+
+#include "game_protocol.hpp"
+#include "latency_histogram.hpp"
+
+namespace protocol = tictactoe::protocol;
+using tictactoe::GameRules;
+using tictactoe::LatencyHistogram;
+using tictactoe::Seat;
+
+TEST_CASE("Requests survive formatting and parsing", "[protocol]")
+{
+  const GameRules rules{ 15, 15, 5 };
+  REQUIRE(protocol::format(protocol::NewGame{ rules }) == "NEW 15 15 5\n");
+
+  const auto create = protocol::parse_request("NEW 15 15 5\n").value();
+  REQUIRE(std::get<protocol::NewGame>(create).rules == rules);
+
+  const auto move = std::get<protocol::MakeMove>(protocol::parse_request("MOVE 42 3 7\r\n").value());
+  REQUIRE(move.game == 42);
+  REQUIRE(move.row == 3);
+  REQUIRE(move.col == 7);
+
+  REQUIRE(std::holds_alternative<protocol::JoinGame>(protocol::parse_request("JOIN 1").value()));
+  REQUIRE(std::holds_alternative<protocol::LeaveGame>(protocol::parse_request("LEAVE 1").value()));
+  REQUIRE(std::holds_alternative<protocol::QueryStats>(protocol::parse_request("STATS").value()));
+}
+
+TEST_CASE("Malformed requests are rejected", "[protocol]")
+{
+  REQUIRE_FALSE(protocol::parse_request(""));
+  REQUIRE_FALSE(protocol::parse_request("HELLO"));
+  REQUIRE_FALSE(protocol::parse_request("NEW 3 3"));
+  REQUIRE_FALSE(protocol::parse_request("NEW 3 3 3 3"));
+  REQUIRE_FALSE(protocol::parse_request("NEW 0 3 3"));
+  REQUIRE_FALSE(protocol::parse_request("NEW 1000 3 3"));
+  REQUIRE_FALSE(protocol::parse_request("MOVE 1 -1 0"));
+  REQUIRE_FALSE(protocol::parse_request("MOVE 1 x 0"));
+  REQUIRE_FALSE(protocol::parse_request("JOIN  1"));
+}
+
+TEST_CASE("Replies survive formatting and parsing", "[protocol]")
+{
+  const protocol::Reply replies[] = {
+    protocol::GameJoined{ 7, Seat::Circle, GameRules{ 4, 5, 3 } },
+    protocol::MoveMade{ 7, 1, 2 },
+    protocol::GameLeft{ 7 },
+    protocol::StatsReport{ { { "games", 3 }, { "moves", 12 } } },
+    protocol::Error{ "not your turn" },
+  };
+  for (const auto &reply : replies) {
+    const auto line = protocol::format(reply);
+    REQUIRE(line.back() == '\n');
+    REQUIRE(protocol::format(protocol::parse_reply(line).value()) == line);
+  }
+  REQUIRE(protocol::format(replies[0]) == "GAME 7 circle 4 5 3\n");
+}
+
+TEST_CASE("Latency histogram percentiles are within a bucket", "[protocol]")
+{
+  STATIC_REQUIRE(LatencyHistogram::bucket_of(0) == 0);
+  STATIC_REQUIRE(LatencyHistogram::bucket_of(7) == 7);
+  STATIC_REQUIRE(LatencyHistogram::bucket_of(8) == 8);
+  STATIC_REQUIRE(LatencyHistogram::bucket_of(~std::uint64_t{ 0 }) == LatencyHistogram::kBuckets - 1);
+  STATIC_REQUIRE(LatencyHistogram::lower_bound(LatencyHistogram::bucket_of(1000)) <= 1000);
+
+  LatencyHistogram histogram;
+  REQUIRE(histogram.percentile(0.5) == 0);
+  for (std::uint64_t v = 1; v <= 1000; ++v) { histogram.record(v); }
+  REQUIRE(histogram.count() == 1000);
+  const auto p50 = histogram.percentile(0.50);
+  const auto p99 = histogram.percentile(0.99);
+  REQUIRE(p50 <= 500);
+  REQUIRE(p50 >= 500 - 500 / LatencyHistogram::kSubBuckets);
+  REQUIRE(p99 <= 990);
+  REQUIRE(p99 >= 990 - 990 / LatencyHistogram::kSubBuckets);
+}
@@ -0,0 +1,238 @@
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include "batch_simulation.hpp"
+#include "game_record.hpp"
+
+using tictactoe::FieldState;
+using tictactoe::GameRecord;
+using tictactoe::GameRecordReader;
+using tictactoe::GameRecordWriter;
+using tictactoe::GameRules;
+using tictactoe::MappedFile;
+using tictactoe::Player;
+using tictactoe::Position;
+using tictactoe::ReplayGame;
+
+namespace {
+std::vector<std::uint8_t> file_with(const GameRules &rules, const std::vector<GameRecord> &records)
+{
+  const auto header = tictactoe::game_record::make_header(rules);
+  std::vector<std::uint8_t> bytes(header.begin(), header.end());
+  for (const auto &record : records) { tictactoe::game_record::encode(record, bytes); }
+  return bytes;
+}
+
+// X wins along the top row on move 5
+const GameRecord kTopRow{ GameRules::square(3), { 0, 3, 1, 4, 2 } };
+}// namespace
+
+TEST_CASE("Varints round trip", "[record]")
+{
+  const auto value = GENERATE(std::uint64_t{ 0 }, std::uint64_t{ 127 }, std::uint64_t{ 128 }, std::uint64_t{ 300 }, ~std::uint64_t{ 0 });
+  std::vector<std::uint8_t> bytes;
+  tictactoe::game_record::append_varint(bytes, value);
+  std::size_t offset = 0;
+  REQUIRE(tictactoe::game_record::read_varint(bytes, offset).value() == value);
+  REQUIRE(offset == bytes.size());
+}
+
+TEST_CASE("Varints beyond 64 bits are rejected", "[record]")
+{
+  // nine continued bytes and a 10th with more than bit 63 set
+  std::vector<std::uint8_t> bytes(9, 0xFF);
+  bytes.push_back(0x02);
+  std::size_t offset = 0;
+  REQUIRE_FALSE(tictactoe::game_record::read_varint(bytes, offset));
+}
+
+TEST_CASE("Small boards take one byte per move", "[record]")
+{
+  std::vector<std::uint8_t> bytes;
+  tictactoe::game_record::encode(kTopRow, bytes);
+  // length and five moves; the rules are in the file header
+  REQUIRE(bytes.size() == 1 + 5);
+}
+
+TEST_CASE("Record headers hold the rules of the file", "[record]")
+{
+  const GameRules rules{ 300, 17, 5 };
+  const auto header = tictactoe::game_record::make_header(rules);
+  REQUIRE(tictactoe::game_record::parse_header(header).value() == rules);
+
+  auto corrupt = header;
+  corrupt[4] = 1;
+  REQUIRE_FALSE(tictactoe::game_record::parse_header(corrupt));
+  REQUIRE_FALSE(tictactoe::game_record::parse_header(std::span{ header.data(), 8 }));
+}
+
+TEST_CASE("Records are streamed back in order", "[record]")
+{
+  const GameRules rules{ 15, 15, 5 };
+  const GameRecord first{ rules, { 112, 0, 224, 200 } };
+  const GameRecord second{ rules, { 7, 8 } };
+  const auto bytes = file_with(rules, { first, second, GameRecord{ rules, {} } });
+
+  auto reader = GameRecordReader::create(bytes).value();
+  REQUIRE(reader.rules() == rules);
+  GameRecord record;
+  REQUIRE(reader.next(record).value());
+  REQUIRE(record.rules == rules);
+  REQUIRE(record.moves == first.moves);
+  REQUIRE(reader.next(record).value());
+  REQUIRE(record.rules == rules);
+  REQUIRE(record.moves == second.moves);
+  REQUIRE(reader.next(record).value());
+  REQUIRE(record.moves.empty());
+  REQUIRE_FALSE(reader.next(record).value());
+}
+
+TEST_CASE("Malformed record files are rejected", "[record]")
+{
+  auto bytes = file_with(kTopRow.rules, { kTopRow });
+
+  SECTION("wrong header")
+  {
+    bytes[0] = 'X';
+    REQUIRE_FALSE(GameRecordReader::create(bytes));
+  }
+  SECTION("truncated record")
+  {
+    bytes.pop_back();
+    auto reader = GameRecordReader::create(bytes).value();
+    GameRecord record;
+    REQUIRE_FALSE(reader.next(record));
+  }
+  SECTION("move off the board")
+  {
+    bytes.back() = 9;
+    auto reader = GameRecordReader::create(bytes).value();
+    GameRecord record;
+    REQUIRE_FALSE(reader.next(record));
+  }
+}
+
+TEST_CASE("Replaying a record reconstructs the engine", "[record]")
+{
+  const auto engine = ReplayGame(kTopRow).value();
+  REQUIRE(engine.maybe_winner() == Player::CrossPlayer);
+
+  const auto midgame = ReplayGame(kTopRow, 2).value();
+  REQUIRE_FALSE(midgame.maybe_winner());
+  REQUIRE(midgame.get_active_player() == Player::CrossPlayer);
+  REQUIRE(midgame.get_field_state_at(Position::create_position_for_engine(1, 0, midgame).value()) == FieldState::Circle);
+
+  SECTION("illegal moves fail the replay")
+  {
+    REQUIRE_FALSE(ReplayGame(GameRecord{ GameRules::square(3), { 4, 4 } }));
+    auto after_win = kTopRow;
+    after_win.moves.push_back(8);
+    REQUIRE_FALSE(ReplayGame(after_win));
+  }
+}
+
+TEST_CASE("Written files can be mapped and read", "[record]")
+{
+  const auto path = std::filesystem::temp_directory_path() / "tictactoe_game_record_test.ttr";
+  std::filesystem::remove(path);
+  {
+    auto writer = GameRecordWriter::open(path, kTopRow.rules).value();
+    REQUIRE(writer.append(kTopRow));
+    REQUIRE_FALSE(writer.append(GameRecord{ GameRules::square(4), { 0 } }));
+  }
+  {
+    // reopening appends without writing a second header
+    auto writer = GameRecordWriter::open(path, kTopRow.rules).value();
+    REQUIRE(writer.append(kTopRow));
+  }
+  // but only for games by the same rules
+  REQUIRE_FALSE(GameRecordWriter::open(path, GameRules::square(4)));
+
+  const auto file = MappedFile::open(path, MappedFile::Access::Sequential).value();
+  auto reader = GameRecordReader::create(file.bytes()).value();
+  GameRecord record;
+  int count = 0;
+  while (reader.next(record).value()) {
+    REQUIRE(record.moves == kTopRow.moves);
+    ++count;
+  }
+  REQUIRE(count == 2);
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("Files that are not game records are not appended to", "[record]")
+{
+  const auto path = std::filesystem::temp_directory_path() / "tictactoe_not_a_record_test.ttr";
+  {
+    std::FILE *file = std::fopen(path.string().c_str(), "wb");
+    REQUIRE(file != nullptr);
+    std::fputs("just some text, long enough for a header", file);
+    std::fclose(file);
+  }
+  REQUIRE_FALSE(GameRecordWriter::open(path, kTopRow.rules));
+  REQUIRE(std::filesystem::file_size(path) == 40);
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("Rules too large for the header are not written", "[record]")
+{
+  const auto path = std::filesystem::temp_directory_path() / "tictactoe_large_rules_test.ttr";
+  std::filesystem::remove(path);
+  // one more than the largest side parse_header accepts, and one beyond 16 bits
+  for (const int side : { (1 << 15) + 1, 1 << 16 }) {
+    const auto opened = GameRecordWriter::open(path, GameRules{ 3, side, 3 });
+    REQUIRE_FALSE(opened);
+    REQUIRE(opened.error() == std::errc::argument_out_of_domain);
+  }
+  REQUIRE_FALSE(std::filesystem::exists(path));
+
+  const GameRules largest{ 1 << 15, 3, 3 };
+  {
+    auto writer = GameRecordWriter::open(path, largest).value();
+    REQUIRE(writer.flush());
+  }
+  const auto file = MappedFile::open(path, MappedFile::Access::Sequential).value();
+  REQUIRE(GameRecordReader::create(file.bytes()).value().rules() == largest);
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("Simulated games can be recorded and replayed", "[record][simulation]")
+{
+  const auto path = std::filesystem::temp_directory_path() / "tictactoe_simulation_record_test.ttr";
+  std::filesystem::remove(path);
+  tictactoe::SimulationOptions options;
+  // enough games to fill the buffers of both threads several times
+  options.games = 20'000;
+  options.threads = 2;
+  auto writer = GameRecordWriter::open(path, options.rules).value();
+  const auto result = tictactoe::RunSimulation(options, &writer).value();
+
+  const auto file = MappedFile::open(path, MappedFile::Access::Sequential).value();
+  auto reader = GameRecordReader::create(file.bytes()).value();
+  GameRecord record;
+  std::uint64_t games = 0;
+  std::uint64_t cross_wins = 0;
+  while (reader.next(record).value()) {
+    const auto engine = ReplayGame(record).value();
+    if (engine.maybe_winner() == Player::CrossPlayer) { ++cross_wins; }
+    ++games;
+  }
+  REQUIRE(games == result.games);
+  REQUIRE(cross_wins == result.cross_wins);
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("Simulations only record to a file for their rules", "[record][simulation]")
+{
+  const auto path = std::filesystem::temp_directory_path() / "tictactoe_simulation_rules_test.ttr";
+  std::filesystem::remove(path);
+  auto writer = GameRecordWriter::open(path, GameRules::square(4)).value();
+  tictactoe::SimulationOptions options;
+  REQUIRE_FALSE(tictactoe::RunSimulation(options, &writer));
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,170 @@
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "game_client.hpp"
+#include "game_server.hpp"
+
+namespace protocol = tictactoe::protocol;
+using tictactoe::GameClient;
+using tictactoe::GameRules;
+using tictactoe::GameServer;
+using tictactoe::Seat;
+using tictactoe::ServerOptions;
+
+namespace {
+constexpr std::chrono::seconds kTimeout{ 5 };
+
+std::unique_ptr<GameServer> start_server(unsigned threads, std::size_t max_games = 16)
+{
+  ServerOptions options;
+  options.port = 0;
+  options.threads = threads;
+  options.shards = 4;
+  options.max_games_per_connection = max_games;
+  return GameServer::start(options).value();
+}
+
+template<typename T> T expect(GameClient &client)
+{
+  auto reply = client.wait(kTimeout).value();
+  if (const auto *error = std::get_if<protocol::Error>(&reply)) { FAIL("server error: " << error->reason); }
+  REQUIRE(std::holds_alternative<T>(reply));
+  return std::get<T>(reply);
+}
+}// namespace
+
+TEST_CASE("Two clients play a game through the server", "[server]")
+{
+  auto server = start_server(2);
+  auto cross = GameClient::connect("127.0.0.1", server->port()).value();
+  auto circle = GameClient::connect("127.0.0.1", server->port()).value();
+
+  REQUIRE(cross.send(protocol::NewGame{ GameRules{ 3, 3, 3 } }));
+  const auto created = expect<protocol::GameJoined>(cross);
+  REQUIRE(created.seat == Seat::Both);
+
+  // the creator's first move is replayed to whoever joins later
+  REQUIRE(cross.send(protocol::MakeMove{ created.game, 0, 0 }));
+  expect<protocol::MoveMade>(cross);
+
+  REQUIRE(circle.send(protocol::JoinGame{ created.game }));
+  REQUIRE(expect<protocol::GameJoined>(circle).seat == Seat::Circle);
+  const auto replayed = expect<protocol::MoveMade>(circle);
+  REQUIRE(replayed.row == 0);
+  REQUIRE(replayed.col == 0);
+  REQUIRE(expect<protocol::GameJoined>(cross).seat == Seat::Cross);
+
+  // cross may no longer move for circle
+  REQUIRE(cross.send(protocol::MakeMove{ created.game, 1, 1 }));
+  REQUIRE(std::holds_alternative<protocol::Error>(cross.wait(kTimeout).value()));
+
+  REQUIRE(circle.send(protocol::MakeMove{ created.game, 1, 1 }));
+  REQUIRE(expect<protocol::MoveMade>(circle).row == 1);
+  REQUIRE(expect<protocol::MoveMade>(cross).col == 1);
+
+  REQUIRE(circle.send(protocol::LeaveGame{ created.game }));
+  REQUIRE(expect<protocol::GameLeft>(circle).game == created.game);
+  REQUIRE(expect<protocol::GameLeft>(cross).game == created.game);
+  REQUIRE(server->metrics().games_active == 0);
+
+  // the game is gone for both
+  for (auto *client : { &cross, &circle }) {
+    REQUIRE(client->send(protocol::LeaveGame{ created.game }));
+    const auto reply = client->wait(kTimeout).value();
+    REQUIRE(std::holds_alternative<protocol::Error>(reply));
+    REQUIRE(std::get<protocol::Error>(reply).reason == "not in game");
+  }
+}
+
+TEST_CASE("Server hosts many concurrent games", "[server]")
+{
+  constexpr int kGames = 100;
+  auto server = start_server(4);
+
+  std::vector<GameClient> crosses;
+  std::vector<GameClient> circles;
+  std::vector<std::uint64_t> ids;
+  for (int g = 0; g < kGames; ++g) {
+    crosses.push_back(GameClient::connect("127.0.0.1", server->port()).value());
+    circles.push_back(GameClient::connect("127.0.0.1", server->port()).value());
+    REQUIRE(crosses.back().send(protocol::NewGame{ GameRules{ 3, 3, 3 } }));
+  }
+  for (int g = 0; g < kGames; ++g) {
+    ids.push_back(expect<protocol::GameJoined>(crosses[static_cast<std::size_t>(g)]).game);
+    REQUIRE(circles[static_cast<std::size_t>(g)].send(protocol::JoinGame{ ids.back() }));
+  }
+  for (int g = 0; g < kGames; ++g) {
+    const auto i = static_cast<std::size_t>(g);
+    expect<protocol::GameJoined>(circles[i]);
+    expect<protocol::GameJoined>(crosses[i]);
+  }
+
+  // cross wins along the top row in every game
+  const int moves[][2] = { { 0, 0 }, { 1, 0 }, { 0, 1 }, { 1, 1 }, { 0, 2 } };
+  for (int m = 0; m < 5; ++m) {
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+      auto &mover = m % 2 == 0 ? crosses[i] : circles[i];
+      REQUIRE(mover.send(protocol::MakeMove{ ids[i], moves[m][0], moves[m][1] }));
+    }
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+      REQUIRE(expect<protocol::MoveMade>(crosses[i]).row == moves[m][0]);
+      REQUIRE(expect<protocol::MoveMade>(circles[i]).col == moves[m][1]);
+    }
+  }
+
+  REQUIRE(circles[0].send(protocol::MakeMove{ ids[0], 2, 2 }));
+  REQUIRE(std::get<protocol::Error>(circles[0].wait(kTimeout).value()).reason == "game is over");
+
+  const auto metrics = server->metrics();
+  REQUIRE(metrics.connections == 2 * kGames);
+  REQUIRE(metrics.games_created == kGames);
+  REQUIRE(metrics.games_active == kGames);
+  REQUIRE(metrics.moves == 5 * kGames);
+  REQUIRE(metrics.latency_p99_ns >= metrics.latency_p50_ns);
+  REQUIRE(metrics.requests_per_second() > 0.0);
+
+  crosses.clear();
+  circles.clear();
+  const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+  while (server->metrics().connections > 0 and std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+  }
+  REQUIRE(server->metrics().games_active == 0);
+}
+
+TEST_CASE("Server limits the games one connection opens", "[server]")
+{
+  auto server = start_server(2, 2);
+  auto client = GameClient::connect("127.0.0.1", server->port()).value();
+
+  std::vector<std::uint64_t> ids;
+  for (int g = 0; g < 2; ++g) {
+    REQUIRE(client.send(protocol::NewGame{ GameRules{ 3, 3, 3 } }));
+    ids.push_back(expect<protocol::GameJoined>(client).game);
+  }
+  REQUIRE(client.send(protocol::NewGame{ GameRules{ 3, 3, 3 } }));
+  const auto reply = client.wait(kTimeout).value();
+  REQUIRE(std::holds_alternative<protocol::Error>(reply));
+  REQUIRE(std::get<protocol::Error>(reply).reason == "too many games");
+  REQUIRE(server->metrics().games_created == 2);
+
+  // joining counts against the same limit
+  auto other = GameClient::connect("127.0.0.1", server->port()).value();
+  REQUIRE(other.send(protocol::NewGame{ GameRules{ 3, 3, 3 } }));
+  const auto open = expect<protocol::GameJoined>(other);
+  REQUIRE(client.send(protocol::JoinGame{ open.game }));
+  const auto refused = client.wait(kTimeout).value();
+  REQUIRE(std::holds_alternative<protocol::Error>(refused));
+  REQUIRE(std::get<protocol::Error>(refused).reason == "too many games");
+
+  // and a free place makes room again
+  REQUIRE(client.send(protocol::LeaveGame{ ids[0] }));
+  expect<protocol::GameLeft>(client);
+  REQUIRE(client.send(protocol::JoinGame{ open.game }));
+  REQUIRE(expect<protocol::GameJoined>(client).seat == Seat::Circle);
+}
@@ -0,0 +1,123 @@
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "input_script.hpp"
+
+using tictactoe::format_event;
+using tictactoe::format_rules;
+using tictactoe::GameRules;
+using tictactoe::parse_input_script;
+using tictactoe::ScriptedClick;
+using tictactoe::ScriptedEvent;
+using tictactoe::ScriptedMove;
+using tictactoe::ScriptedRedo;
+using tictactoe::ScriptedResize;
+using tictactoe::ScriptedUndo;
+using tictactoe::synthetic_input_script;
+
+TEST_CASE("Input scripts parse rules, clicks and resizes", "[input_script]")
+{
+  const auto script = parse_input_script("# recorded\n"
+                                         "rules 15 15 5\n"
+                                         "\n"
+                                         "click 12.5 3\n"
+                                         "resize  800\t600\r\n"
+                                         "click -1 401.25");
+  REQUIRE(script);
+  REQUIRE(script.value().rules == GameRules{ 15, 15, 5 });
+  REQUIRE(script.value().events.size() == 3);
+  REQUIRE(script.value().events[0] == ScriptedEvent{ ScriptedClick{ 12.5f, 3.0f } });
+  REQUIRE(script.value().events[1] == ScriptedEvent{ ScriptedResize{ 800, 600 } });
+  REQUIRE(script.value().events[2] == ScriptedEvent{ ScriptedClick{ -1.0f, 401.25f } });
+}
+
+TEST_CASE("Input scripts parse moves, undo and redo", "[input_script]")
+{
+  const auto script = parse_input_script("click 1 2\n"
+                                         "move 7 3\n"
+                                         "undo\n"
+                                         "undo \n"
+                                         "redo\n");
+  REQUIRE(script);
+  REQUIRE(script.value().events == std::vector<ScriptedEvent>{ ScriptedClick{ 1.0f, 2.0f }, ScriptedMove{ 7, 3 }, ScriptedUndo{}, ScriptedUndo{}, ScriptedRedo{} });
+}
+
+TEST_CASE("Malformed input script lines are rejected", "[input_script]")
+{
+  const auto line = GENERATE(as<std::string>{},
+    "tap 1 2",
+    "click 1",
+    "click 1 2 3",
+    "click one 2",
+    "resize 0 600",
+    "resize -800 600",
+    "move 1",
+    "move 1 a",
+    "undo 1",
+    "redo redo",
+    "click 1 2\nrules 3 3 3",
+    "rules 3 3 3\nrules 3 3 3");
+  REQUIRE_FALSE(parse_input_script(line));
+}
+
+TEST_CASE("Formatted events and rules parse back unchanged", "[input_script]")
+{
+  const GameRules rules{ 8, 9, 4 };
+  const auto synthetic = synthetic_input_script(rules, 300.0f, 200.0f, 100, 10, 3);
+  REQUIRE(synthetic.events.size() == 100);
+
+  std::string text = format_rules(rules) + '\n';
+  for (const auto& event : synthetic.events) {
+    text += format_event(event) + '\n';
+  }
+  const auto parsed = parse_input_script(text);
+  REQUIRE(parsed);
+  REQUIRE(parsed.value().rules == rules);
+  REQUIRE(parsed.value().events == synthetic.events);
+}
+
+TEST_CASE("Synthetic scripts click on the board and resize periodically", "[input_script]")
+{
+  const auto script = synthetic_input_script(GameRules::square(3), 300.0f, 200.0f, 50, 5, 1);
+  REQUIRE(script.rules == GameRules::square(3));
+  for (std::size_t i = 0; i < script.events.size(); ++i) {
+    if ((i + 1) % 5 == 0) {
+      const auto& resize = std::get<ScriptedResize>(script.events[i]);
+      REQUIRE(resize.width >= 320);
+      REQUIRE(resize.height <= 1080);
+    } else {
+      const auto& click = std::get<ScriptedClick>(script.events[i]);
+      REQUIRE(click.x >= 0.0f);
+      REQUIRE(click.x <= 300.0f);
+      REQUIRE(click.y <= 200.0f);
+    }
+  }
+}
+
+TEST_CASE("Recorded input scripts read back with their rules", "[input_script]")
+{
+  const auto path = std::filesystem::temp_directory_path() / "tictactoe_input_script_test.txt";
+  {
+    auto writer = tictactoe::InputScriptWriter::open(path, GameRules{ 4, 5, 3 });
+    REQUIRE(writer);
+    REQUIRE(writer.value().append(ScriptedResize{ 1024, 768 }));
+    REQUIRE(writer.value().append(ScriptedClick{ 150.5f, 20.0f }));
+    REQUIRE(writer.value().append(ScriptedMove{ 2, 4 }));
+    REQUIRE(writer.value().append(ScriptedUndo{}));
+    REQUIRE(writer.value().append(ScriptedRedo{}));
+
+    // flushed events can be read while the writer is still open
+    REQUIRE(writer.value().flush());
+    REQUIRE(tictactoe::read_input_script(path).value().events.size() == 5);
+  }
+
+  const auto script = tictactoe::read_input_script(path);
+  std::filesystem::remove(path);
+  REQUIRE(script);
+  REQUIRE(script.value().rules == GameRules{ 4, 5, 3 });
+  REQUIRE(script.value().events == std::vector<ScriptedEvent>{ ScriptedResize{ 1024, 768 }, ScriptedClick{ 150.5f, 20.0f }, ScriptedMove{ 2, 4 }, ScriptedUndo{}, ScriptedRedo{} });
+}
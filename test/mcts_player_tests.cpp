@@ -0,0 +1,126 @@
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <utility>
+#include <vector>
+
+#include "mcts_player.hpp"
+#include "play_moves.hpp"
+
+using tictactoe::Engine;
+using tictactoe::GameRules;
+using tictactoe::MctsLimits;
+using tictactoe::MctsPlayer;
+using tictactoe::Position;
+using tictactoe::test::play;
+
+namespace {
+MctsLimits limits(std::uint64_t playouts, unsigned threads = 1)
+{
+  MctsLimits l;
+  l.playouts = playouts;
+  l.time_budget = std::chrono::seconds{ 10 };
+  l.threads = threads;
+  return l;
+}
+
+const GameRules kClassic{ 3, 3, 3 };
+}// namespace
+
+TEST_CASE("MCTS takes an immediate win", "[mcts]")
+{
+  // X: (0,0) (0,1); O: (1,0) (1,1); X to move wins at (0,2)
+  const auto engine = play(kClassic, { { 0, 0 }, { 1, 0 }, { 0, 1 }, { 1, 1 } });
+  MctsPlayer player{ kClassic, limits(5000) };
+  const auto move = player.choose_move(engine).value();
+  REQUIRE(move.row() == 0);
+  REQUIRE(move.col() == 2);
+
+  const auto &stats = player.last_search_statistics();
+  REQUIRE(stats.playouts == 5000);
+  REQUIRE(stats.win_rate > 0.9);
+  REQUIRE(stats.playouts_per_second() > 0.0);
+}
+
+TEST_CASE("MCTS blocks the opponent's line", "[mcts]")
+{
+  // X: (0,0) (2,2); O: (1,1) (1,0); X must block at (1,2)
+  const auto engine = play(kClassic, { { 0, 0 }, { 1, 1 }, { 2, 2 }, { 1, 0 } });
+  MctsPlayer player{ kClassic, limits(5000, 2) };
+  const auto move = player.choose_move(engine).value();
+  REQUIRE(move.row() == 1);
+  REQUIRE(move.col() == 2);
+  REQUIRE(player.last_search_statistics().threads == 2);
+  REQUIRE(player.last_search_statistics().playouts == 5000);
+}
+
+TEST_CASE("MCTS keeps its tree when the game continues", "[mcts]")
+{
+  const GameRules rules{ 7, 7, 4 };
+  auto engine = play(rules, {});
+  // wide enough that the reply below is in the tree
+  auto l = limits(2000);
+  l.widening = 100.0;
+  MctsPlayer player{ rules, l };
+
+  const auto first = player.choose_move(engine).value();
+  REQUIRE(player.last_search_statistics().reused_playouts == 0);
+  REQUIRE(engine.handle_field_selected(first));
+  REQUIRE(engine.handle_field_selected(
+    Position::create_position_for_engine(first.row() == 0 ? 1 : 0, 0, engine).value()));
+
+  REQUIRE(player.choose_move(engine));
+  REQUIRE(player.last_search_statistics().reused_playouts > 0);
+
+  // taking moves back leaves the searched line, so the tree starts over
+  REQUIRE(engine.undo());
+  REQUIRE(engine.undo());
+  REQUIRE(player.choose_move(engine));
+  REQUIRE(player.last_search_statistics().reused_playouts == 0);
+}
+
+TEST_CASE("MCTS stops growing the tree at the node limit", "[mcts]")
+{
+  const GameRules rules{ 9, 9, 5 };
+  const auto engine = play(rules, {});
+  auto l = limits(500);
+  l.max_nodes = 100;
+  MctsPlayer player{ rules, l };
+  REQUIRE(player.choose_move(engine));
+  REQUIRE(player.last_search_statistics().tree_nodes <= 100);
+  REQUIRE(player.last_search_statistics().playouts == 500);
+}
+
+TEST_CASE("MCTS compacts a full tree it keeps", "[mcts]")
+{
+  const GameRules rules{ 7, 7, 4 };
+  auto engine = play(rules, {});
+  auto l = limits(2000);
+  l.widening = 100.0;
+  l.max_nodes = 1000;
+  MctsPlayer player{ rules, l };
+
+  REQUIRE(engine.handle_field_selected(player.choose_move(engine).value()));
+  REQUIRE(player.last_search_statistics().tree_nodes == 1000);
+  REQUIRE(engine.handle_field_selected(player.choose_move(engine).value()));
+  REQUIRE(player.last_search_statistics().reused_playouts > 0);
+  REQUIRE(player.last_search_statistics().tree_nodes <= 1000);
+  REQUIRE(player.last_search_statistics().playouts == 2000);
+}
+
+TEST_CASE("MCTS adds at most one node per playout", "[mcts]")
+{
+  const GameRules rules{ 25, 25, 5 };
+  const auto engine = play(rules, { { 12, 12 } });
+  MctsPlayer player{ rules, limits(1000) };
+  REQUIRE(player.choose_move(engine));
+  REQUIRE(player.last_search_statistics().playouts == 1000);
+  REQUIRE(player.last_search_statistics().tree_nodes <= 1001);
+}
+
+TEST_CASE("MCTS refuses to move in a finished game", "[mcts]")
+{
+  const auto engine = play(kClassic, { { 1, 0 }, { 0, 0 }, { 1, 1 }, { 0, 1 }, { 1, 2 } });
+  MctsPlayer player{ kClassic, limits(100) };
+  REQUIRE_FALSE(player.choose_move(engine));
+}
@@ -0,0 +1,138 @@
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "metrics.hpp"
+
+using std::chrono::nanoseconds;
+using tictactoe::LatencyHistogram;
+using tictactoe::metrics::Registry;
+using tictactoe::metrics::ScopedTimer;
+
+TEST_CASE("the registry hands out one metric per name", "[metrics]")
+{
+  Registry registry;
+  auto& first = registry.timing("test_seconds", "first");
+  auto& second = registry.timing("test_seconds", "second");
+  REQUIRE(&first == &second);
+  REQUIRE(first.help() == "first");
+
+  auto& counter = registry.counter("test_total", "events");
+  REQUIRE(&counter == &registry.counter("test_total", "events"));
+}
+
+TEST_CASE("scoped timers only record while enabled", "[metrics]")
+{
+  Registry registry;
+  auto& timing = registry.timing("test_seconds", "test");
+  {
+    const ScopedTimer timer{ timing };
+  }
+  REQUIRE(timing.histogram().count() == 0);
+
+  registry.set_enabled(true);
+  {
+    const ScopedTimer timer{ timing };
+  }
+  REQUIRE(timing.histogram().count() == 1);
+}
+
+TEST_CASE("sampled timings scale their count back up", "[metrics]")
+{
+  Registry registry;
+  registry.set_enabled(true);
+  auto& timing = registry.timing("test_seconds", "test", 4);
+  for (int i = 0; i < 400; ++i) {
+    const ScopedTimer timer{ timing };
+  }
+  REQUIRE(timing.histogram().count() == 100);
+
+  const auto summaries = registry.timing_summaries();
+  REQUIRE(summaries.size() == 1);
+  REQUIRE(summaries[0].name == "test_seconds");
+  REQUIRE(summaries[0].count == 400);
+}
+
+TEST_CASE("interleaved sampled timings keep separate call counts", "[metrics]")
+{
+  Registry registry;
+  registry.set_enabled(true);
+  auto& every_fourth = registry.timing("fourth_seconds", "test", 4);
+  auto& every_other = registry.timing("other_seconds", "test", 2);
+  for (int i = 0; i < 400; ++i) {
+    {
+      const ScopedTimer timer{ every_fourth };
+    }
+    // calls to one timing must not shift which calls of the other are sampled
+    for (int j = 0; j < i % 3; ++j) {
+      const ScopedTimer timer{ every_other };
+    }
+  }
+  REQUIRE(every_fourth.histogram().count() == 100);
+  REQUIRE(every_other.histogram().count() == 399 / 2);
+}
+
+TEST_CASE("sampled timings count the calls of each thread separately",
+          "[metrics]")
+{
+  Registry registry;
+  registry.set_enabled(true);
+  auto& timing = registry.timing("test_seconds", "test", 4);
+  const auto three_calls = [&timing] {
+    for (int i = 0; i < 3; ++i) {
+      const ScopedTimer timer{ timing };
+    }
+  };
+  std::thread first{ three_calls };
+  first.join();
+  std::thread second{ three_calls };
+  second.join();
+  // six calls in total, but no thread reached its fourth
+  REQUIRE(timing.histogram().count() == 0);
+}
+
+TEST_CASE("summaries report the percentiles of the recorded times",
+          "[metrics]")
+{
+  Registry registry;
+  auto& timing = registry.timing("test_seconds", "test");
+  for (int i = 0; i < 90; ++i) {
+    timing.record(nanoseconds{ 100 });
+  }
+  for (int i = 0; i < 10; ++i) {
+    timing.record(nanoseconds{ 1'000'000 });
+  }
+
+  // both are reported as the lower bound of their histogram bucket
+  const auto bucket_start = [](std::uint64_t ns) {
+    return nanoseconds{ static_cast<std::int64_t>(
+      LatencyHistogram::lower_bound(LatencyHistogram::bucket_of(ns))) };
+  };
+  const auto summary = registry.timing_summaries().at(0);
+  REQUIRE(summary.count == 100);
+  REQUIRE(summary.p50 == bucket_start(100));
+  REQUIRE(summary.p99 == bucket_start(1'000'000));
+}
+
+TEST_CASE("metrics are exported in the Prometheus text format", "[metrics]")
+{
+  Registry registry;
+  auto& timing = registry.timing("test_seconds", "Time a test takes");
+  timing.record(nanoseconds{ 2'000 });
+  registry.counter("test_total", "Tests run").add(3);
+
+  const auto text = registry.prometheus_text();
+  REQUIRE(text ==
+      "# HELP test_seconds Time a test takes\n"
+      "# TYPE test_seconds summary\n"
+      "test_seconds{quantile=\"0.5\"} 1.92e-06\n"
+      "test_seconds{quantile=\"0.99\"} 1.92e-06\n"
+      "test_seconds_sum 2e-06\n"
+      "test_seconds_count 1\n"
+      "# HELP test_total Tests run\n"
+      "# TYPE test_total counter\n"
+      "test_total 3\n");
+}
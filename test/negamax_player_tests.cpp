@@ -0,0 +1,69 @@
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <utility>
+#include <vector>
+
+#include "negamax_player.hpp"
+#include "play_moves.hpp"
+
+using tictactoe::Engine;
+using tictactoe::NegamaxPlayer;
+using tictactoe::Position;
+using tictactoe::SearchLimits;
+using tictactoe::test::play;
+
+namespace {
+constexpr SearchLimits kGenerousLimits{ std::chrono::seconds{ 10 }, 0 };
+}// namespace
+
+TEST_CASE("Negamax solves the empty 3x3 board as a draw", "[negamax]")
+{
+  const auto engine = play(3, {});
+  NegamaxPlayer player{ engine.rules(), kGenerousLimits, 16 };
+  REQUIRE(player.choose_move(engine));
+
+  const auto &stats = player.last_search_statistics();
+  REQUIRE(stats.solved);
+  REQUIRE(stats.score == 0);
+  REQUIRE(stats.nodes > 0);
+  REQUIRE(stats.tt_hits > 0);
+  REQUIRE(stats.tt_hit_rate() > 0.0);
+}
+
+TEST_CASE("Negamax takes an immediate win", "[negamax]")
+{
+  // X: (0,0) (0,1); O: (1,0) (1,1); X to move wins at (0,2)
+  const auto engine = play(3, { { 0, 0 }, { 1, 0 }, { 0, 1 }, { 1, 1 } });
+  NegamaxPlayer player{ engine.rules(), kGenerousLimits, 16 };
+  const auto move = player.choose_move(engine).value();
+  REQUIRE(move.row() == 0);
+  REQUIRE(move.col() == 2);
+  REQUIRE(player.last_search_statistics().score > NegamaxPlayer::kWinThreshold);
+}
+
+TEST_CASE("Negamax blocks the opponent's line", "[negamax]")
+{
+  // X: (0,0) (2,2); O: (1,1) (1,0); X must block at (1,2)
+  const auto engine = play(3, { { 0, 0 }, { 1, 1 }, { 2, 2 }, { 1, 0 } });
+  NegamaxPlayer player{ engine.rules(), kGenerousLimits, 16 };
+  const auto move = player.choose_move(engine).value();
+  REQUIRE(move.row() == 1);
+  REQUIRE(move.col() == 2);
+}
+
+TEST_CASE("Negamax refuses to move in a finished game", "[negamax]")
+{
+  const auto engine = play(3, { { 1, 0 }, { 0, 0 }, { 1, 1 }, { 0, 1 }, { 1, 2 } });
+  NegamaxPlayer player{ engine.rules(), kGenerousLimits, 16 };
+  REQUIRE_FALSE(player.choose_move(engine));
+}
+
+TEST_CASE("Negamax respects the depth limit on larger boards", "[negamax]")
+{
+  const auto engine = play(5, {});
+  NegamaxPlayer player{ engine.rules(), SearchLimits{ std::chrono::seconds{ 10 }, 2 }, 16 };
+  REQUIRE(player.choose_move(engine));
+  REQUIRE(player.last_search_statistics().completed_depth == 2);
+  REQUIRE_FALSE(player.last_search_statistics().solved);
+}
@@ -0,0 +1,102 @@
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "negamax_player.hpp"
+#include "opening_book.hpp"
+#include "parallel_solver.hpp"
+#include "play_moves.hpp"
+
+using tictactoe::Engine;
+using tictactoe::GameRules;
+using tictactoe::GameValue;
+using tictactoe::MappedFile;
+using tictactoe::OpeningBook;
+using tictactoe::Position;
+using tictactoe::test::play;
+
+namespace {
+const OpeningBook &book_3x3()
+{
+  static const auto book =
+    OpeningBook::from_file(MappedFile::in_memory(OpeningBook::generate(GameRules::square(3)).value())).value();
+  return book;
+}
+}// namespace
+
+TEST_CASE("3x3 book stores one of each symmetric undecided position", "[book]")
+{
+  // 765 essentially different reachable positions, 138 of them decided
+  REQUIRE(book_3x3().size() == 627);
+  REQUIRE(book_3x3().rules() == GameRules::square(3));
+}
+
+TEST_CASE("Book values agree with the solver", "[book]")
+{
+  std::mt19937 rng{ 7 };
+  tictactoe::ParallelSolver solver{ GameRules::square(3), tictactoe::SolverOptions{ 1, 2, 16 } };
+  for (int game = 0; game < 20; ++game) {
+    auto engine = Engine::create_engine(3).value();
+    while (const auto entry = book_3x3().probe(engine)) {
+      REQUIRE(entry->value == solver.solve(engine).value().value);
+
+      // the best move keeps the value
+      Engine child = engine;
+      REQUIRE(child.handle_field_selected(entry->best_move));
+      if (!child.maybe_winner()) {
+        if (const auto reply = book_3x3().probe(child)) {
+          REQUIRE(static_cast<int>(reply->value) == -static_cast<int>(entry->value));
+        }
+      }
+
+      const int cell = std::uniform_int_distribution<int>{ 0, 8 }(rng);
+      (void)engine.handle_field_selected(Position::create_position_for_engine(cell / 3, cell % 3, engine).value());
+    }
+  }
+}
+
+TEST_CASE("Book moves follow the position through symmetries", "[book]")
+{
+  // cross in a corner: circle must take the centre, whichever corner it is
+  for (const auto &[row, col] : std::vector<std::pair<int, int>>{ { 0, 0 }, { 0, 2 }, { 2, 0 }, { 2, 2 } }) {
+    const auto entry = book_3x3().probe(play(3, { { row, col } })).value();
+    REQUIRE(entry.value == GameValue::Draw);
+    REQUIRE(entry.best_move.row() == 1);
+    REQUIRE(entry.best_move.col() == 1);
+  }
+}
+
+TEST_CASE("Book finds the quickest win", "[book]")
+{
+  // cross can complete the top row right away
+  const auto entry = book_3x3().probe(play(3, { { 0, 0 }, { 1, 0 }, { 0, 1 }, { 1, 1 } })).value();
+  REQUIRE(entry.value == GameValue::Win);
+  REQUIRE(entry.plies_to_end == 1);
+  REQUIRE(entry.best_move.row() == 0);
+  REQUIRE(entry.best_move.col() == 2);
+}
+
+TEST_CASE("Book is only used where it applies", "[book]")
+{
+  REQUIRE_FALSE(book_3x3().probe(Engine::create_engine(4).value()));
+  REQUIRE_FALSE(book_3x3().probe(play(3, { { 1, 0 }, { 0, 0 }, { 1, 1 }, { 0, 1 }, { 1, 2 } })));
+  REQUIRE_FALSE(OpeningBook::generate(GameRules::square(5)));
+  REQUIRE_FALSE(OpeningBook::generate(GameRules{ 3, 4, 3 }));
+  REQUIRE_FALSE(OpeningBook::from_file(MappedFile::in_memory({ 'T', 'T', 'T', 'B' })));
+}
+
+TEST_CASE("Negamax player answers book positions without searching", "[book][negamax]")
+{
+  tictactoe::NegamaxPlayer player{ GameRules::square(3), tictactoe::SearchLimits{} };
+  auto book = OpeningBook::from_file(MappedFile::in_memory(OpeningBook::generate(GameRules::square(3)).value())).value();
+  player.set_opening_book(std::make_shared<const OpeningBook>(std::move(book)));
+
+  const auto move = player.choose_move(play(3, { { 0, 0 } })).value();
+  REQUIRE(move.row() == 1);
+  REQUIRE(move.col() == 1);
+  REQUIRE(player.last_search_statistics().from_book);
+  REQUIRE(player.last_search_statistics().nodes == 0);
+}
@@ -0,0 +1,60 @@
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <vector>
+
+#include "engine.hpp"
+#include "packed_board.hpp"
+
+using tictactoe::Engine;
+using tictactoe::FieldState;
+using tictactoe::GameRules;
+using tictactoe::PackedBoard;
+
+TEST_CASE("Packed board stores fields independently", "[packed_board]")
+{
+  // odd size, so the last word is only partly used
+  constexpr std::size_t kCells = 101;
+  PackedBoard board{ kCells };
+  std::vector<FieldState> reference(kCells, FieldState::Empty);
+  REQUIRE(board.size() == kCells);
+  REQUIRE(board.bytes() == 4 * sizeof(PackedBoard::Word));
+
+  std::mt19937 rng{ 3 };
+  std::uniform_int_distribution<std::size_t> cell{ 0, kCells - 1 };
+  std::uniform_int_distribution<int> state{ 0, 2 };
+  for (int i = 0; i < 1000; ++i) {
+    const auto c = cell(rng);
+    const auto s = static_cast<FieldState>(state(rng));
+    board.set(c, s);
+    reference[c] = s;
+  }
+
+  REQUIRE(std::vector<FieldState>(board.begin(), board.end()) == reference);
+  REQUIRE_THROWS_AS(board.at(kCells), std::out_of_range);
+}
+
+TEST_CASE("Packed board lines walk any direction", "[packed_board]")
+{
+  PackedBoard board{ 9 };
+  board.set(2, FieldState::Cross);
+  board.set(4, FieldState::Circle);
+  board.set(6, FieldState::Cross);
+
+  const std::vector<FieldState> antidiagonal{ FieldState::Cross, FieldState::Circle, FieldState::Cross };
+  const auto down = board.line(2, 2, 3);
+  REQUIRE(std::vector<FieldState>(down.begin(), down.end()) == antidiagonal);
+  const auto up = board.line(6, -2, 3);
+  REQUIRE(std::vector<FieldState>(up.begin(), up.end()) == antidiagonal);
+  const auto empty = board.line(0, 1, 0);
+  REQUIRE(empty.begin() == empty.end());
+}
+
+TEST_CASE("Engine board takes a sixteenth of the unpacked layout", "[packed_board]")
+{
+  const auto engine = Engine::create_engine(GameRules{ 1024, 1024, 5 }).value();
+  const auto memory = engine.memory_usage();
+  REQUIRE(memory.board_bytes == 1024 * 1024 / 4);
+  REQUIRE(memory.unpacked_board_bytes == 16 * memory.board_bytes);
+  REQUIRE(memory.total_bytes > memory.board_bytes);
+}
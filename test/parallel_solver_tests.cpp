@@ -0,0 +1,44 @@
+#include <catch2/catch.hpp>
+
+#include <utility>
+#include <vector>
+
+#include "parallel_solver.hpp"
+#include "play_moves.hpp"
+
+using tictactoe::Engine;
+using tictactoe::GameValue;
+using tictactoe::ParallelSolver;
+using tictactoe::Position;
+using tictactoe::SolverOptions;
+using tictactoe::test::play;
+
+TEST_CASE("Parallel solver finds 3x3 to be a draw", "[solver]")
+{
+  const auto threads = GENERATE(1U, 2U, 4U);
+  const auto engine = play(3, {});
+  ParallelSolver solver{ engine.rules(), SolverOptions{ threads, 2, 16 } };
+  const auto result = solver.solve(engine).value();
+  REQUIRE(result.value == GameValue::Draw);
+  REQUIRE(result.threads == threads);
+  REQUIRE(result.tasks == 72);
+  REQUIRE(result.best_move);
+}
+
+TEST_CASE("Parallel solver sees through a fork", "[solver]")
+{
+  // X threatens both (1,2) and (2,0); O to move cannot block both.
+  const auto engine = play(3, { { 0, 0 }, { 0, 1 }, { 1, 1 }, { 2, 2 }, { 1, 0 } });
+  ParallelSolver solver{ engine.rules(), SolverOptions{ 2, 1, 16 } };
+  const auto result = solver.solve(engine).value();
+  REQUIRE(result.value == GameValue::Loss);
+}
+
+TEST_CASE("Parallel solver reports a decided game as lost", "[solver]")
+{
+  const auto engine = play(3, { { 1, 0 }, { 0, 0 }, { 1, 1 }, { 0, 1 }, { 1, 2 } });
+  ParallelSolver solver{ engine.rules(), SolverOptions{ 2, 2, 16 } };
+  const auto result = solver.solve(engine).value();
+  REQUIRE(result.value == GameValue::Loss);
+  REQUIRE_FALSE(result.best_move);
+}
@@ -0,0 +1,31 @@
+#ifndef TICTACTOE_TEST_PLAY_MOVES_H_
+#define TICTACTOE_TEST_PLAY_MOVES_H_
+
+#include <catch2/catch.hpp>
+
+#include <utility>
+#include <vector>
+
+#include "engine.hpp"
+
+namespace tictactoe::test {
+
+// A new game by rules with the (row, col) moves played, alternating from X.
+inline Engine play(const GameRules &rules, const std::vector<std::pair<int, int>> &moves)
+{
+  auto engine = Engine::create_engine(rules).value();
+  for (const auto &[row, col] : moves) {
+    const auto pos = Position::create_position_for_engine(row, col, engine).value();
+    REQUIRE(engine.handle_field_selected(pos));
+  }
+  return engine;
+}
+
+inline Engine play(int board_size, const std::vector<std::pair<int, int>> &moves)
+{
+  return play(GameRules::square(board_size), moves);
+}
+
+}// namespace tictactoe::test
+
+#endif// TICTACTOE_TEST_PLAY_MOVES_H_